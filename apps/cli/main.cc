@@ -6,18 +6,32 @@
 #include <optional>
 #include <functional>
 #include <exception>
+#include <algorithm>
+#include <charconv>
+#include <memory>
+#include <vector>
 
 #include "fmt/core.h"
 
 #include "fel/lexer.h"
+#include "fel/streamlexer.h"
+#include "fel/tokenbuffer.h"
+#include "fel/parallellexer.h"
+#include "fel/threadpool.h"
+#include "fel/writer.h"
 #include "fel/file.h"
 #include "fel/log.h"
 
 // testing
 #include "fel/ast.h"
 #include "fel/ast_printer.h"
+#include "fel/fold.h"
 #include "fel/parser.h"
+#include "fel/typeinference.h"
 #include "fel/interpreter.h"
+#include "fel/bytecode.h"
+#include "fel/jit.h"
+#include "fel/vm.h"
 
 #include "lsp/lsp.h"
 
@@ -25,12 +39,23 @@
 using namespace fel;
 
 
+// where a file writes, when files are run in parallel each file gets its own
+// buffers that are printed in argument order
+struct Output
+{
+    Writer& out;
+    std::ostream& err;
+};
+
+
 void
-Print(const Log& log)
+Print(const Log& log, const Output& output)
 {
     if(!log.IsEmpty())
     {
-        std::cerr << log;
+        // keep the order of what has been printed so far
+        output.out.Flush();
+        output.err << log;
     }
 }
 
@@ -62,6 +87,10 @@ struct Options
 {
     Mode mode = Mode::Run;
     bool treat_file_as_code = false;
+    bool use_vm = false;
+    bool fold_constants = false;
+    bool infer_types = false;
+    JitMode jit = JitMode::Auto;
     bool print_log = true;
     bool print_output = true;
     std::string log_file = "fel-lsp.log";
@@ -69,7 +98,7 @@ struct Options
 
 
 std::optional<File>
-ReadFile(const std::string& path, const Options& opt)
+ReadFile(const std::string& path, const Options& opt, const Output& output)
 {
     if(opt.treat_file_as_code)
     {
@@ -77,25 +106,16 @@ ReadFile(const std::string& path, const Options& opt)
     }
     else if(path == "stdin")
     {
-        const auto content = std::string
-        (
-            std::istreambuf_iterator<char>(std::cin),
-            std::istreambuf_iterator<char>()
-        );
-        return File{"stdin", content};
+        return ReadStream("stdin", std::cin);
     }
-    else if(auto t = std::ifstream{path.c_str()}; t.good())
+    else if(auto file = MapFile(path); file)
     {
-        const auto content = std::string
-        (
-            std::istreambuf_iterator<char>(t),
-            std::istreambuf_iterator<char>()
-        );
-        return File{path, content};
+        return file;
     }
     else
     {
-        std::cerr << "Failed to open " << path << "\n";
+        output.out.Flush();
+        output.err << "Failed to open " << path << "\n";
         return std::nullopt;
     }
 }
@@ -177,22 +197,21 @@ RunLanguageServer(const std::string& log_path)
 
 
 int
-HandleTokenize(const File& file, const Options& opt)
+HandleTokenize(const File& file, const Options& opt, const Output& output, ThreadPool* lex_pool)
 {
     Log log;
-    auto reader = LexerReader{file, &log};
-    auto tokens = GetAllTokensInFile(&reader);
+    const auto tokens = LexFileParallel(file, &log, lex_pool);
     if(opt.print_log)
     {
-        Print(log);
+        Print(log, output);
     }
     if(opt.print_output)
     {
         if(log.IsEmpty())
         {
-            for(auto token : tokens)
+            for(std::size_t i=0; i<tokens.GetSize(); i+=1)
             {
-                std::cout << token << "\n";
+                output.out << ToString(tokens.types[i]) << ": " << tokens.GetLexeme(i) << '\n';
             }
         }
     }
@@ -201,55 +220,179 @@ HandleTokenize(const File& file, const Options& opt)
 }
 
 
+// the stream lexer doesn't decode literals, numbers are checked like LexFile does
+bool
+IsNumberInRange(const StreamToken& token)
+{
+    int int_value = 0;
+    float number_value = 0;
+    switch(token.type)
+    {
+    case TokenType::Int: return DecodeInt(token.text, &int_value);
+    case TokenType::Number: return DecodeNumber(token.text, &number_value);
+    default: return true;
+    }
+}
+
+
+// tokens are printed as they are lexed so standard input of any size can be
+// tokenized without first reading all of it
+int
+HandleTokenizeStream(const Options& opt, const Output& output)
+{
+    // read the descriptor instead of std::cin so read errors are reported,
+    // stdin is 0 on all platforms
+    Log log;
+    auto lexer = StreamLexer{"stdin", ReadFromDescriptor(0), &log};
+    for(auto token = lexer.GetNextToken(); token.type != TokenType::EndOfStream; token = lexer.GetNextToken())
+    {
+        if(!IsNumberInRange(token))
+        {
+            log.AddError(Where{lexer.file, token.location}, log::Type::NumberOutOfRange, {std::string{token.text}});
+        }
+        if(opt.print_output)
+        {
+            output.out << ToString(token.type) << ": " << token.GetLexeme() << '\n';
+        }
+    }
+    if(opt.print_log)
+    {
+        Print(log, output);
+    }
+
+    return log.IsEmpty() ? 0 : -1;
+}
+
+
 int
-HandleParse(const File& file, const Options& opt)
+HandleParse(const File& file, const Options& opt, const Output& output)
 {
     Log log;
     auto parser = Parser{file, &log};
-    auto parsed_expression = parser.Parse();
+    auto ast = parser.Parse();
+    if(ast && opt.fold_constants) { ast = FoldConstants(*ast); }
+    if(ast && opt.infer_types) { InferTypes(&*ast, &log); }
 
     if(opt.print_log)
     {
-        Print(log);
+        Print(log, output);
     }
 
-    if(opt.print_output && parsed_expression != nullptr)
+    if(opt.print_output && ast)
     {
-        std::cout << AstPrinter{}.Visit(parsed_expression.get()) << "\n";
+        output.out << AstPrinter{}.Print(*ast) << '\n';
     }
 
-    return log.IsEmpty() && parsed_expression != nullptr ? 0 : -1;
+    return log.IsEmpty() && ast ? 0 : -1;
 }
 
 
 int
-HandleRun(const File& file, const Options& opt)
+HandleRun(const File& file, const Options& opt, const Output& output)
 {
     Log log;
     auto parser = Parser{file, &log};
-    auto parsed_expression = parser.Parse();
+    auto ast = parser.Parse();
+    if(ast && opt.fold_constants) { ast = FoldConstants(*ast); }
+    if(ast && opt.infer_types) { InferTypes(&*ast, &log); }
 
-    if(opt.print_log) { Print(log); }
+    if(opt.print_log) { Print(log, output); }
 
-    if(!(log.IsEmpty() && parsed_expression != nullptr))
+    if(!(log.IsEmpty() && ast))
     {
         return -1;
     }
 
-    auto interpreter = Interpreter{&log};
-    auto result = interpreter.Evaluate(parsed_expression);
+    Value result;
+    if(opt.use_vm)
+    {
+        const auto code = Compile(*ast, &log);
+        if(!code)
+        {
+            if(opt.print_log) { Print(log, output); }
+            return -1;
+        }
+        auto vm = Vm{&log};
+        result = vm.Run(*code);
+    }
+    else
+    {
+        auto expression = TieredExpression{&*ast, &log, opt.jit};
+        result = expression.Evaluate();
+    }
 
-    if(opt.print_log) { Print(log); }
+    if(opt.print_log) { Print(log, output); }
 
     if(opt.print_output && log.IsEmpty())
     {
-        std::cout << Stringify(result) << "\n";
+        output.out << result << '\n';
     }
 
     return log.IsEmpty() ? 0 : -2;
 }
 
 
+struct FileToRun
+{
+    std::string path;
+    Options options;
+};
+
+
+int
+HandleFile(const FileToRun& f, const Output& output, ThreadPool* lex_pool)
+{
+    const auto& opt = f.options;
+    if(opt.mode == Mode::Tokenize && !opt.treat_file_as_code && f.path == "stdin")
+    {
+        return HandleTokenizeStream(opt, output);
+    }
+
+    const auto file = ReadFile(f.path, opt, output);
+    if(!file)
+    {
+        return 0;
+    }
+
+    switch(opt.mode)
+    {
+    case Mode::Tokenize:
+        return HandleTokenize(*file, opt, output, lex_pool);
+    case Mode::Parse:
+        return HandleParse(*file, opt, output);
+    case Mode::Run:
+        return HandleRun(*file, opt, output);
+    default:
+        output.err << "Unknown mode!\n";
+        return -2;
+    }
+}
+
+
+// the output is flushed and a failed write is an error even if the files ran
+int
+FinishOutput(Writer* out, int return_value)
+{
+    out->Flush();
+    if(out->HasFailed())
+    {
+        std::cerr << "Failed to write output: " << out->error << "\n";
+        return return_value != 0 ? return_value : -3;
+    }
+    return return_value;
+}
+
+
+// the whole value must be a number, a typo shouldn't quietly become 0
+bool
+ParseCount(const std::string& value, std::size_t* count)
+{
+    const auto* end = value.data() + value.size();
+    const auto [parsed_end, error] = std::from_chars(value.data(), end, *count);
+    return error == std::errc{} && parsed_end == end;
+}
+
+
 int
 main(int argc, char* argv[])
 {
@@ -274,6 +417,12 @@ main(int argc, char* argv[])
             << "  -s     make silent\n"
             << "  -S     make super silent\n"
             << "  --code the FILE is not a file but code\n"
+            << "  --jobs N  run N files at the same time, 0 is one per core\n"
+            << "  --threads N  lex a file with N threads when tokenizing, 0 (default) is one per core\n"
+            << "  --vm   compile to bytecode and run it instead of walking the tree\n"
+            << "  --fold replace the expressions of only literals with their value\n"
+            << "  --types  check the types before running and run the known types unboxed\n"
+            << "  --jit MODE  on, off or auto to compile to native code when it's run often\n"
             << "\n"
             << "mode selection:\n"
             << "  --tokenize   instead of running, just tokenize the input\n"
@@ -291,13 +440,22 @@ main(int argc, char* argv[])
         return 0;
     }
     Options opt;
-    std::optional<std::function<void (const std::string&)>> next_option = std::nullopt;
+    std::size_t jobs = 1;
+    std::size_t lex_threads = 0;
+    std::vector<FileToRun> files;
+    // a option that takes a value returns false if the value is invalid
+    std::optional<std::function<bool (const std::string&)>> next_option = std::nullopt;
     for(int i=1; i<argc; i+=1)
     {
         if(next_option.has_value())
         {
-            next_option.value()(argv[i]);
+            const auto is_valid = next_option.value()(argv[i]);
             next_option = std::nullopt;
+            if(is_valid == false)
+            {
+                PrintUsage();
+                return -1;
+            }
         }
         else if(IsArgument(argv[i]))
         {
@@ -320,11 +478,39 @@ main(int argc, char* argv[])
             {
                 opt.treat_file_as_code = true;
             }
+            else if(a == "-vm")
+            {
+                opt.use_vm = true;
+            }
+            else if(a == "-fold")
+            {
+                opt.fold_constants = true;
+            }
+            else if(a == "-types")
+            {
+                opt.infer_types = true;
+            }
+            else if(a == "-jit")
+            {
+                next_option = [&](const std::string& v)
+                {
+                    if(v == "on") { opt.jit = JitMode::On; }
+                    else if(v == "off") { opt.jit = JitMode::Off; }
+                    else if(v == "auto") { opt.jit = JitMode::Auto; }
+                    else
+                    {
+                        std::cerr << "Invalid jit mode: " << v << "\n";
+                        return false;
+                    }
+                    return true;
+                };
+            }
             else if(a == "-log")
             {
                 next_option = [&](const std::string& v)
                 {
                     opt.log_file = v;
+                    return true;
                 };
             }
             else if(a =="-tokenize")
@@ -335,6 +521,30 @@ main(int argc, char* argv[])
             {
                 opt.mode = Mode::Parse;
             }
+            else if(a == "-jobs")
+            {
+                next_option = [&](const std::string& v)
+                {
+                    if(ParseCount(v, &jobs) == false)
+                    {
+                        std::cerr << "Invalid option: --jobs " << v << "\n";
+                        return false;
+                    }
+                    return true;
+                };
+            }
+            else if(a == "-threads")
+            {
+                next_option = [&](const std::string& v)
+                {
+                    if(ParseCount(v, &lex_threads) == false)
+                    {
+                        std::cerr << "Invalid option: --threads " << v << "\n";
+                        return false;
+                    }
+                    return true;
+                };
+            }
             else if(a == "-lsp")
             {
                 // todo(Gustav): get log from cmdline
@@ -349,30 +559,7 @@ main(int argc, char* argv[])
         }
         else
         {
-            if(const auto file = ReadFile(argv[i], opt))
-            {
-                const int return_value = [&]()
-                {
-                    switch(opt.mode)
-                    {
-                    case Mode::Tokenize:
-                        return HandleTokenize(*file, opt);
-                    case Mode::Parse:
-                        return HandleParse(*file, opt);
-                    case Mode::Run:
-                        return HandleRun(*file, opt);
-                    default:
-                        std::cerr << "Unknown mode!\n";
-                        return -2;
-                    }
-                }();
-
-                if(return_value != 0)
-                {
-                    return return_value;
-                }
-            }
-
+            files.emplace_back(FileToRun{argv[i], opt});
             opt = Options{};
         }
     }
@@ -383,5 +570,49 @@ main(int argc, char* argv[])
         return -2;
     }
 
-    return 0;
+    // files are run on one pool and large files are lexed on another, so
+    // running one file at a time still lexes with every core
+    const bool is_tokenizing = std::any_of
+    (
+        files.begin(), files.end(),
+        [](const FileToRun& f) { return f.options.mode == Mode::Tokenize; }
+    );
+    auto lex_pool = is_tokenizing ? std::make_unique<ThreadPool>(lex_threads) : nullptr;
+    auto pool = jobs != 1 ? std::make_unique<ThreadPool>(jobs) : nullptr;
+
+    auto out = Writer{WriteToFile(stdout)};
+    if(jobs == 1)
+    {
+        const auto output = Output{out, std::cerr};
+        for(const auto& f: files)
+        {
+            const int return_value = HandleFile(f, output, lex_pool.get());
+            if(return_value != 0 || out.HasFailed())
+            {
+                return FinishOutput(&out, return_value);
+            }
+        }
+        return FinishOutput(&out, 0);
+    }
+
+    // every file is run, the first error in argument order is returned
+    std::vector<std::string> outs(files.size());
+    std::vector<std::ostringstream> errs(files.size());
+    std::vector<int> return_values(files.size(), 0);
+    pool->ForEach(files.size(), [&](std::size_t index)
+    {
+        auto file_out = Writer{WriteToString(&outs[index])};
+        const auto output = Output{file_out, errs[index]};
+        return_values[index] = HandleFile(files[index], output, lex_pool.get());
+    });
+
+    int return_value = 0;
+    for(std::size_t index = 0; index < files.size(); index += 1)
+    {
+        out.Flush();
+        std::cerr << errs[index].str();
+        out << outs[index];
+        if(return_value == 0) { return_value = return_values[index]; }
+    }
+    return FinishOutput(&out, return_value);
 }
@@ -0,0 +1,54 @@
+#include "fel/arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace fel
+{
+    Arena::Arena(std::size_t a_block_size)
+        : block_size(a_block_size)
+    {
+    }
+
+
+    void*
+    Arena::Allocate(std::size_t size, std::size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        assert(alignment <= alignof(std::max_align_t));
+
+        while(current_block < blocks.size())
+        {
+            auto& block = blocks[current_block];
+            const auto address = reinterpret_cast<std::uintptr_t>(block.data.get()) + used;
+            const auto padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+            if(used + padding + size <= block.size)
+            {
+                void* memory = block.data.get() + used + padding;
+                used += padding + size;
+                return memory;
+            }
+
+            current_block += 1;
+            used = 0;
+        }
+
+        // new blocks are aligned for anything so only really big
+        // allocations need a block of their own size
+        const auto new_size = std::max(block_size, size);
+        // not make_unique, there is no need to clear the memory
+        blocks.emplace_back(Block{std::unique_ptr<char[]>(new char[new_size]), new_size});
+        current_block = blocks.size() - 1;
+        used = size;
+        return blocks.back().data.get();
+    }
+
+
+    void
+    Arena::Reset()
+    {
+        current_block = 0;
+        used = 0;
+    }
+}
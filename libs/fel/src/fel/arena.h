@@ -0,0 +1,44 @@
+#ifndef FEL_ARENA_H
+#define FEL_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace fel
+{
+    // hands out memory from big blocks, nothing is freed on its own but
+    // everything is released at once by Reset. Destructors are never run so
+    // only put things there that doesn't need them
+    struct Arena
+    {
+        static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+        explicit Arena(std::size_t a_block_size = DefaultBlockSize);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        void*
+        Allocate(std::size_t size, std::size_t alignment);
+
+        // release everything, the blocks are kept for the next use
+        void
+        Reset();
+
+        std::size_t block_size;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t size;
+        };
+
+        std::vector<Block> blocks;
+        std::size_t current_block = 0;
+        std::size_t used = 0;
+    };
+}
+
+#endif  // FEL_ARENA_H
@@ -0,0 +1,55 @@
+#include "catch.hpp"
+
+#include <cstdint>
+#include <string>
+
+#include "fel/arena.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+
+using namespace fel;
+
+
+TEST_CASE("arena", "[arena]")
+{
+    auto arena = Arena{64};
+
+    auto* a = static_cast<char*>(arena.Allocate(3, 1));
+    auto* b = arena.Allocate(8, 8);
+    CHECK(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+    CHECK(static_cast<char*>(b) >= a + 3);
+
+    // bigger than a block
+    auto* big = arena.Allocate(1000, 8);
+    CHECK(big != nullptr);
+
+    // the first block is used again
+    arena.Reset();
+    CHECK(arena.Allocate(3, 1) == a);
+}
+
+
+TEST_CASE("arena-interpreter", "[arena]")
+{
+    const auto source = std::string{"'a string that is ' + 'longer than the small ' + 'ones, and ' + 'long enough to be a rope'"};
+    const auto expected = std::string{"a string that is longer than the small ones, and long enough to be a rope"};
+
+    Log log;
+    const auto file = File{"source", source};
+    auto parser = Parser{file, &log};
+    const auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    auto interpreter = Interpreter{&log};
+    const auto first = interpreter.Evaluate(*ast);
+    for(int i=0; i<100; i+=1)
+    {
+        CHECK(Stringify(interpreter.Evaluate(*ast)) == expected);
+    }
+
+    // the result is copied out and isn't changed by later evaluations
+    CHECK(log.IsEmpty());
+    CHECK(Stringify(first) == expected);
+}
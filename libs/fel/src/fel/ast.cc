@@ -1,130 +1,93 @@
 #include "fel/ast.h"
 
+#include <cassert>
+
 namespace fel
 {
-    BinaryExpression::BinaryExpression
-    (
-        std::shared_ptr<Expression> l,
-        const Token& o,
-        std::shared_ptr<Expression> r
-    )
-        : left(l)
-        , op(o)
-        , right(r)
+    namespace
     {
+        NodeIndex
+        AddNode(Ast* ast, Node node)
+        {
+            assert(ast->nodes.size() < NoNode);
+            ast->nodes.emplace_back(node);
+            return static_cast<NodeIndex>(ast->nodes.size() - 1);
+        }
     }
 
 
-    Where
-    BinaryExpression::GetLocation()
+    NodeIndex
+    Ast::AddBinary(NodeIndex left, const Token& op, NodeIndex right)
     {
-        return left->GetLocation();
+        assert(file == op.file);
+        return AddNode(this, {NodeType::Binary, op.type, Quickening::Unseen, 0, op.offset, op.length, left, right});
     }
 
 
-    std::string
-    BinaryExpression::Visit(ExpressionVisitorString* visitor)
-    {
-        return visitor->Visit(this);
-    }
-
-    std::shared_ptr<Object>
-    BinaryExpression::Visit(ExpressionVisitorObject* visitor)
+    NodeIndex
+    Ast::AddGrouping(NodeIndex expression)
     {
-        return visitor->Visit(this);
+        return AddNode(this, {NodeType::Grouping, TokenType::Unknown, Quickening::Unseen, 0, 0, 0, NoNode, expression});
     }
 
 
-    // ------------------------------------------------------------------------
-
-
-    GroupingExpression::GroupingExpression(std::shared_ptr<Expression> e)
-        : expression(e)
+    NodeIndex
+    Ast::AddLiteral(Value value, const Token& token)
     {
+        assert(file == token.file);
+        const auto literal = static_cast<std::uint32_t>(literals.size());
+        literals.emplace_back(std::move(value));
+        return AddNode(this, {NodeType::Literal, token.type, Quickening::Unseen, 0, token.offset, token.length, NoNode, literal});
     }
 
 
-    Where
-    GroupingExpression::GetLocation()
+    NodeIndex
+    Ast::AddUnary(const Token& op, NodeIndex right)
     {
-        return expression->GetLocation();
+        assert(file == op.file);
+        return AddNode(this, {NodeType::Unary, op.type, Quickening::Unseen, 0, op.offset, op.length, NoNode, right});
     }
 
 
-    std::string
-    GroupingExpression::Visit(ExpressionVisitorString* visitor)
+    NodeIndex
+    Ast::AddVariable(Symbol name, const Token& token)
     {
-        return visitor->Visit(this);
+        assert(file == token.file);
+        const auto variable = static_cast<std::uint32_t>(variables.size());
+        variables.emplace_back(name);
+        return AddNode(this, {NodeType::Variable, token.type, Quickening::Unseen, 0, token.offset, token.length, NoNode, variable});
     }
 
 
-    std::shared_ptr<Object>
-    GroupingExpression::Visit(ExpressionVisitorObject* visitor)
+    Token
+    Ast::GetToken(NodeIndex index) const
     {
-        return visitor->Visit(this);
+        const auto& node = GetNode(index);
+        return {node.op, node.offset, node.length, file};
     }
 
 
-    // ------------------------------------------------------------------------
-
-
-    LiteralExpression::LiteralExpression(std::shared_ptr<Object> v, const Where& w)
-        : value(v)
-        , where(w)
+    NodeIndex
+    Ast::GetFirstNode(NodeIndex index) const
     {
+        // a binary expression starts where the left side starts and a
+        // grouping where the expression starts
+        while(true)
+        {
+            const auto& node = GetNode(index);
+            switch(node.type)
+            {
+            case NodeType::Binary: index = node.left; break;
+            case NodeType::Grouping: index = node.right; break;
+            default: return index;
+            }
+        }
     }
 
 
     Where
-    LiteralExpression::GetLocation()
-    {
-        return where;
-    }
-
-
-    std::string
-    LiteralExpression::Visit(ExpressionVisitorString* visitor)
-    {
-        return visitor->Visit(this);
-    }
-
-    std::shared_ptr<Object>
-    LiteralExpression::Visit(ExpressionVisitorObject* visitor)
-    {
-        return visitor->Visit(this);
-    }
-
-
-    // ------------------------------------------------------------------------
-
-
-    UnaryExpression::UnaryExpression
-    (
-        const Token& o,
-        std::shared_ptr<Expression> r
-    )
-        : op(o)
-        , right(r)
-    {
-    }
-
-
-    Where
-    UnaryExpression::GetLocation()
-    {
-        return op.where;
-    }
-
-
-    std::string
-    UnaryExpression::Visit(ExpressionVisitorString* visitor)
-    {
-        return visitor->Visit(this);
-    }
-
-    std::shared_ptr<Object>
-    UnaryExpression::Visit(ExpressionVisitorObject* visitor)
+    Ast::GetWhere(NodeIndex index) const
     {
-        return visitor->Visit(this);
+        return GetToken(GetFirstNode(index)).GetWhere();
     }
-}
\ No newline at end of file
+}
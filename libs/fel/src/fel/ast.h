@@ -1,132 +1,174 @@
 #ifndef FEL_AST_H
 #define FEL_AST_H
 
+#include <cassert>
+#include <cstdint>
+#include <limits>
 #include <memory>
-#include <string>
+#include <vector>
 
+#include "fel/file.h"
+#include "fel/filetable.h"
 #include "fel/lexer.h"
-#include "fel/object.h"
+#include "fel/symboltable.h"
+#include "fel/tokentype.h"
+#include "fel/value.h"
+#include "fel/where.h"
 
 
 namespace fel
 {
-    struct BinaryExpression;
-    struct GroupingExpression;
-    struct LiteralExpression;
-    struct UnaryExpression;
+    // a index into the nodes of a Ast
+    using NodeIndex = std::uint32_t;
+
+    constexpr NodeIndex NoNode = std::numeric_limits<NodeIndex>::max();
 
-    struct ExpressionVisitorString
-    {
-        virtual ~ExpressionVisitorString() = default;
 
-        virtual std::string Visit(BinaryExpression* exp) = 0;
-        virtual std::string Visit(GroupingExpression* exp) = 0;
-        virtual std::string Visit(LiteralExpression* exp) = 0;
-        virtual std::string Visit(UnaryExpression* exp) = 0;
+    enum class NodeType : std::uint8_t
+    {
+        Binary, Grouping, Literal, Unary, Variable
     };
 
-    struct ExpressionVisitorObject
+
+    // the type of a expression before it's run, the known types are in the
+    // same order as ValueType
+    enum class StaticType : std::uint8_t
     {
-        virtual ~ExpressionVisitorObject() = default;
+        Null, Bool, Int, Number, String,
 
-        virtual std::shared_ptr<Object> Visit(BinaryExpression* exp) = 0;
-        virtual std::shared_ptr<Object> Visit(GroupingExpression* exp) = 0;
-        virtual std::shared_ptr<Object> Visit(LiteralExpression* exp) = 0;
-        virtual std::shared_ptr<Object> Visit(UnaryExpression* exp) = 0;
+        // only known when it's run, or a error
+        Unknown
     };
 
-    struct Expression
-    {
-        virtual ~Expression() = default;
 
-        virtual Where
-        GetLocation() = 0;
+    // the specialized form a binary node is rewritten to when it's run, based
+    // on the types of the operands. Generic is the unspecialized form
+    enum class Quickening : std::uint8_t
+    {
+        Unseen, Generic,
+        IntAdd, IntSubtract, IntMultiply, IntModulo,
+        IntLess, IntLessEqual, IntGreater, IntGreaterEqual, IntEqual, IntNotEqual,
+        NumberAdd, NumberSubtract, NumberMultiply, NumberDivide,
+        NumberLess, NumberLessEqual, NumberGreater, NumberGreaterEqual
+    };
 
-        virtual std::string
-        Visit(ExpressionVisitorString* visitor) = 0;
 
-        virtual std::shared_ptr<Object>
-        Visit(ExpressionVisitorObject* visitor) = 0;
+    // all nodes are the same small size and refer to other nodes by index
+    struct Node
+    {
+        NodeType type;
+
+        // the operator of a Binary or Unary node
+        TokenType op;
+
+        // changed by the interpreter when running so a ast shouldn't be run
+        // on more than one thread at a time, they fit in the padding
+        mutable Quickening quickening;
+        mutable std::uint8_t deoptimizations;
+
+        // the operator or the literal in the source
+        std::uint32_t offset;
+        std::uint32_t length;
+
+        // Binary: left and right
+        // Unary and Grouping: the expression is right
+        // Literal: right is the index in the literal table
+        // Variable: right is the index in the variable table
+        NodeIndex left;
+        NodeIndex right;
     };
 
 
-    struct BinaryExpression : public Expression
+    static_assert(sizeof(Node) <= 20, "nodes should be kept small");
+
+
+    // the nodes of a parsed expression are stored in a single array, children
+    // are added before their parents so the root is last
+    struct Ast
     {
-        std::shared_ptr<Expression> left;
-        Token op;
-        std::shared_ptr<Expression> right;
+        FileId file = UndefinedFile;
 
-        BinaryExpression
-        (
-            std::shared_ptr<Expression> l,
-            const Token& o,
-            std::shared_ptr<Expression> r
-        );
+        // keeps the source and its file table entry alive so the tokens and
+        // locations of the nodes can be read after the parsed file is gone
+        std::shared_ptr<const File> source;
 
-        Where
-        GetLocation() override;
+        std::vector<Node> nodes;
+        std::vector<Value> literals;
+        std::vector<Symbol> variables;
+        NodeIndex root = NoNode;
 
-        std::string
-        Visit(ExpressionVisitorString* visitor) override;
+        // the type of each node, empty until InferTypes is run, see
+        // fel/typeinference.h
+        std::vector<StaticType> types;
 
-        std::shared_ptr<Object>
-        Visit(ExpressionVisitorObject* visitor) override;
-    };
+        // set with the types, true if running the node can report a error.
+        // That is a modulo or a unknown type in it, only the rest can be run
+        // without making values
+        std::vector<bool> can_fail;
 
-    struct GroupingExpression : public Expression
-    {
-        std::shared_ptr<Expression> expression;
+        NodeIndex
+        AddBinary(NodeIndex left, const Token& op, NodeIndex right);
 
-        explicit GroupingExpression(std::shared_ptr<Expression> e);
+        NodeIndex
+        AddGrouping(NodeIndex expression);
 
-        Where
-        GetLocation() override;
+        NodeIndex
+        AddLiteral(Value value, const Token& token);
 
-        std::string
-        Visit(ExpressionVisitorString* visitor) override;
+        NodeIndex
+        AddUnary(const Token& op, NodeIndex right);
 
-        std::shared_ptr<Object>
-        Visit(ExpressionVisitorObject* visitor) override;
-    };
+        NodeIndex
+        AddVariable(Symbol name, const Token& token);
 
-    struct LiteralExpression : public Expression
-    {
-        std::shared_ptr<Object> value;
-        Where where;
+        // inlined below since they are called for every node that is run
+        const Node&
+        GetNode(NodeIndex index) const;
 
-        LiteralExpression(std::shared_ptr<Object> v, const Where& w);
+        const Value&
+        GetLiteral(NodeIndex index) const;
 
-        Where
-        GetLocation() override;
+        Symbol
+        GetVariable(NodeIndex index) const;
 
-        std::string
-        Visit(ExpressionVisitorString* visitor) override;
+        // the operator or the literal of the node
+        Token
+        GetToken(NodeIndex index) const;
 
-        std::shared_ptr<Object>
-        Visit(ExpressionVisitorObject* visitor) override;
+        // the node with the token the expression starts with
+        NodeIndex
+        GetFirstNode(NodeIndex index) const;
+
+        // where the expression starts, used for error messages
+        Where
+        GetWhere(NodeIndex index) const;
     };
-    
-    struct UnaryExpression : public Expression
-    {
-        Token op;
-        std::shared_ptr<Expression> right;
 
-        UnaryExpression
-        (
-            const Token& o,
-            std::shared_ptr<Expression> r
-        );
 
-        Where
-        GetLocation() override;
+    inline const Node&
+    Ast::GetNode(NodeIndex index) const
+    {
+        assert(index < nodes.size());
+        return nodes[index];
+    }
 
-        std::string
-        Visit(ExpressionVisitorString* visitor) override;
 
-        std::shared_ptr<Object>
-        Visit(ExpressionVisitorObject* visitor) override;
-    };
+    inline const Value&
+    Ast::GetLiteral(NodeIndex index) const
+    {
+        const auto& node = GetNode(index);
+        assert(node.type == NodeType::Literal);
+        return literals[node.right];
+    }
+
 
+    inline Symbol
+    Ast::GetVariable(NodeIndex index) const
+    {
+        const auto& node = GetNode(index);
+        assert(node.type == NodeType::Variable);
+        return variables[node.right];
+    }
 }
 
 #endif // FEL_AST_H
@@ -0,0 +1,71 @@
+#include "catch.hpp"
+
+#include <string>
+
+#include "fel/ast.h"
+#include "fel/ast_printer.h"
+#include "fel/file.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+
+using namespace fel;
+
+
+TEST_CASE("ast", "[ast]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"-(1 + 2) * 'a'"}};
+    auto parser = Parser{file, &log};
+    const auto ast = parser.Parse();
+    REQUIRE(ast);
+    CHECK(log.IsEmpty());
+
+    // children are added before their parents
+    REQUIRE(ast->nodes.size() == 7);
+    CHECK(ast->root == 6);
+    CHECK(ast->literals.size() == 3);
+
+    const auto& root = ast->GetNode(ast->root);
+    CHECK(root.type == NodeType::Binary);
+    CHECK(root.op == TokenType::Mult);
+    CHECK(root.left < ast->root);
+    CHECK(root.right < ast->root);
+    CHECK(ast->GetNode(root.left).type == NodeType::Unary);
+    CHECK(Stringify(ast->GetLiteral(root.right)) == "a");
+
+    CHECK(AstPrinter{}.Print(*ast) == "(* (- (group (+ 1 2))) a)");
+
+    // a expression starts where the left most part of it starts
+    CHECK(ast->GetWhere(ast->root).location.column == 0);
+    CHECK(ast->GetWhere(ast->GetNode(root.left).right).location.column == 2);
+}
+
+
+TEST_CASE("ast-outlives-file", "[ast]")
+{
+    Log log;
+    const auto ast = [&]
+    {
+        const auto file = File{"source", std::string{"1 +\n'a'"}};
+        auto parser = Parser{file, &log};
+        return parser.Parse();
+    }();
+    REQUIRE(ast);
+
+    // the ast keeps the source alive so errors can still be reported
+    const auto& root = ast->GetNode(ast->root);
+    CHECK(ast->GetToken(ast->root).GetLexeme() == "+");
+    CHECK(ast->GetToken(root.right).GetLexeme() == "a");
+    CHECK(GetFileName(ast->file) == "source");
+    CHECK(ast->GetWhere(root.right).location.line == 2);
+}
+
+
+TEST_CASE("ast-error", "[ast]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"1 + (2"}};
+    auto parser = Parser{file, &log};
+    CHECK_FALSE(parser.Parse());
+    CHECK_FALSE(log.IsEmpty());
+}
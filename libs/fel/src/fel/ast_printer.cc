@@ -1,32 +1,34 @@
 #include "fel/ast_printer.h"
 
-#include <vector>
+#include <cassert>
+#include <initializer_list>
 #include <sstream>
 
 namespace fel
 {
     std::string
-    AstPrinter::Visit(Expression* expression)
+    AstPrinter::Print(const Ast& ast)
     {
-        return expression->Visit(this);
+        return Print(ast, ast.root);
     }
 
 
     std::string
     Parenthesize
     (
-        const std::string& name,
-        const std::vector<std::shared_ptr<Expression>>& expressions
+        AstPrinter* printer,
+        const Ast& ast,
+        std::string_view name,
+        std::initializer_list<NodeIndex> expressions
     )
     {
         std::ostringstream ss;
 
         ss << "(" << name;
 
-        for(const auto& exp: expressions)
+        for(const auto exp: expressions)
         {
-            AstPrinter visitor;
-            ss << " " << exp->Visit(&visitor);
+            ss << " " << printer->Print(ast, exp);
         }
 
         ss << ")";
@@ -35,43 +37,25 @@ namespace fel
     }
 
 
-    std::string AstPrinter::Visit(BinaryExpression* exp)
-    {
-        return Parenthesize
-        (
-            exp->op.lexeme,
-            {
-                exp->left,
-                exp->right
-            }
-        );
-    }
-
-
-    std::string AstPrinter::Visit(GroupingExpression* exp)
-    {
-        return Parenthesize("group", {exp->expression});
-    }
-
-
-    std::string AstPrinter::Visit(LiteralExpression* exp)
+    std::string
+    AstPrinter::Print(const Ast& ast, NodeIndex index)
     {
-        if(exp->value == nullptr)
+        const auto& node = ast.GetNode(index);
+        switch(node.type)
         {
-            return "null";
+        case NodeType::Binary:
+            return Parenthesize(this, ast, ast.GetToken(index).GetLexeme(), {node.left, node.right});
+        case NodeType::Grouping:
+            return Parenthesize(this, ast, "group", {node.right});
+        case NodeType::Literal:
+            return Stringify(ast.GetLiteral(index));
+        case NodeType::Unary:
+            return Parenthesize(this, ast, ast.GetToken(index).GetLexeme(), {node.right});
+        case NodeType::Variable:
+            return std::string{ast.GetVariable(index)->s};
+        default:
+            assert(false && "unhandled case");
+            return "<internal_error>";
         }
-        else
-        {
-            return exp->value->ToString();
-        }
-        
-    }
-
-
-    std::string AstPrinter::Visit(UnaryExpression* exp)
-    {
-        return Parenthesize(exp->op.lexeme, {exp->right});
     }
-
-
 }
@@ -1,19 +1,18 @@
 #ifndef FEL_AST_PRINTER_H
 #define FEL_AST_PRINTER_H
 
+#include <string>
+
 #include "fel/ast.h"
 
 namespace fel
 {
 
-    struct AstPrinter : public ExpressionVisitorString
+    struct AstPrinter
     {
-        std::string Visit(Expression* expression);
+        std::string Print(const Ast& ast);
 
-        std::string Visit(BinaryExpression* exp) override;
-        std::string Visit(GroupingExpression* exp) override;
-        std::string Visit(LiteralExpression* exp) override;
-        std::string Visit(UnaryExpression* exp) override;
+        std::string Print(const Ast& ast, NodeIndex index);
     };
 
 }
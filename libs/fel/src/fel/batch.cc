@@ -0,0 +1,534 @@
+#include "fel/batch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <limits>
+
+#include "fel/log.h"
+#include "fel/symboltable.h"
+#include "fel/typeinference.h"
+
+#if defined(_MSC_VER)
+#define FEL_RESTRICT __restrict
+#else
+#define FEL_RESTRICT __restrict__
+#endif
+
+namespace fel
+{
+    namespace
+    {
+        // the rows are run a chunk at a time so the values of all nodes stay
+        // in the cache. The loops always run over a whole chunk so the
+        // compiler can turn them into simd code without a scalar tail
+        constexpr std::size_t ChunkSize = 1024;
+
+
+        StaticType
+        ToStaticType(ColumnType type)
+        {
+            switch(type)
+            {
+            case ColumnType::Int: return StaticType::Int;
+            case ColumnType::Number: return StaticType::Number;
+            case ColumnType::Bool: return StaticType::Bool;
+            }
+            return StaticType::Unknown;
+        }
+
+
+        // ------------------------------------------------------------------------
+        // kernels
+
+        template<typename T, typename R, typename Operation>
+        void
+        Map(const T* FEL_RESTRICT values, R* FEL_RESTRICT result, Operation operation)
+        {
+            for(std::size_t i = 0; i < ChunkSize; i += 1)
+            {
+                result[i] = operation(values[i]);
+            }
+        }
+
+        template<typename T, typename R, typename Operation>
+        void
+        Zip(const T* FEL_RESTRICT lhs, const T* FEL_RESTRICT rhs, R* FEL_RESTRICT result, Operation operation)
+        {
+            for(std::size_t i = 0; i < ChunkSize; i += 1)
+            {
+                result[i] = operation(lhs[i], rhs[i]);
+            }
+        }
+
+        // the row fails instead of trapping like the interpreter
+        void
+        Modulo(const std::int32_t* FEL_RESTRICT lhs, const std::int32_t* FEL_RESTRICT rhs, std::int32_t* FEL_RESTRICT result, std::uint8_t* FEL_RESTRICT errors)
+        {
+            for(std::size_t i = 0; i < ChunkSize; i += 1)
+            {
+                const auto fails = rhs[i] == 0 || (lhs[i] == std::numeric_limits<std::int32_t>::min() && rhs[i] == -1);
+                errors[i] |= fails ? 1 : 0;
+                result[i] = fails ? 0 : lhs[i] % rhs[i];
+            }
+        }
+
+        // ints wrap instead of overflowing
+        template<typename Operation>
+        auto
+        Wrapping(Operation operation)
+        {
+            return [operation](std::int32_t lhs, std::int32_t rhs)
+            {
+                return static_cast<std::int32_t>(operation(static_cast<std::uint32_t>(lhs), static_cast<std::uint32_t>(rhs)));
+            };
+        }
+
+
+        // ------------------------------------------------------------------------
+
+        // the values of a node for the rows in the current chunk, it points to
+        // the buffers of the node or into a input column
+        struct Slot
+        {
+            const std::int32_t* ints = nullptr;
+            const float* numbers = nullptr;
+            const std::uint8_t* bools = nullptr;
+        };
+
+
+        struct Buffers
+        {
+            std::vector<std::int32_t> ints;
+            std::vector<float> numbers;
+            std::vector<std::uint8_t> bools;
+
+            // int operands converted to numbers
+            std::vector<float> left;
+            std::vector<float> right;
+        };
+
+
+        struct Evaluator
+        {
+            const BatchProgram& program;
+            const std::vector<const Column*>& columns;
+            const Ast& ast;
+
+            std::vector<Buffers> buffers;
+            std::vector<Slot> slots;
+
+            // the nodes that are the same for all rows are only set once
+            std::vector<bool> is_constant;
+
+            std::vector<std::uint8_t> errors = std::vector<std::uint8_t>(ChunkSize, 0);
+
+            Evaluator(const BatchProgram& p, const std::vector<const Column*>& c)
+                : program(p)
+                , columns(c)
+                , ast(p.ast)
+                , buffers(p.ast.nodes.size())
+                , slots(p.ast.nodes.size())
+                , is_constant(p.ast.nodes.size(), false)
+            {
+                for(NodeIndex index = 0; index < ast.nodes.size(); index += 1)
+                {
+                    Prepare(index);
+                }
+            }
+
+            std::int32_t*
+            Ints(NodeIndex index)
+            {
+                auto& b = buffers[index].ints;
+                if(b.empty()) { b.resize(ChunkSize, 0); }
+                slots[index].ints = b.data();
+                return b.data();
+            }
+
+            float*
+            Numbers(NodeIndex index)
+            {
+                auto& b = buffers[index].numbers;
+                if(b.empty()) { b.resize(ChunkSize, 0.0f); }
+                slots[index].numbers = b.data();
+                return b.data();
+            }
+
+            std::uint8_t*
+            Bools(NodeIndex index)
+            {
+                auto& b = buffers[index].bools;
+                if(b.empty()) { b.resize(ChunkSize, 0); }
+                slots[index].bools = b.data();
+                return b.data();
+            }
+
+            void
+            SetConstant(NodeIndex index, bool value)
+            {
+                std::fill_n(Bools(index), ChunkSize, value ? 1 : 0);
+                is_constant[index] = true;
+            }
+
+            void
+            Prepare(NodeIndex index)
+            {
+                const auto& node = ast.GetNode(index);
+                switch(node.type)
+                {
+                case NodeType::Literal:
+                    {
+                        const auto& value = ast.GetLiteral(index);
+                        switch(value.GetType())
+                        {
+                        case ValueType::Int: std::fill_n(Ints(index), ChunkSize, value.AsInt()); break;
+                        case ValueType::Number: std::fill_n(Numbers(index), ChunkSize, value.AsNumber()); break;
+                        case ValueType::Bool: std::fill_n(Bools(index), ChunkSize, value.AsBool() ? 1 : 0); break;
+                        // only used by == and !, they don't need the value
+                        default: break;
+                        }
+                        is_constant[index] = true;
+                    }
+                    break;
+                case NodeType::Unary:
+                    if(node.op == TokenType::Not)
+                    {
+                        const auto right = ast.types[node.right];
+                        if(right == StaticType::Null) { SetConstant(index, true); }
+                        else if(right != StaticType::Bool) { SetConstant(index, false); }
+                    }
+                    break;
+                case NodeType::Binary:
+                    if(node.op == TokenType::Equal || node.op == TokenType::NotEqual)
+                    {
+                        const auto lhs = ast.types[node.left];
+                        const auto rhs = ast.types[node.right];
+                        if(lhs == StaticType::Null || rhs == StaticType::Null)
+                        {
+                            SetConstant(index, (lhs == rhs) == (node.op == TokenType::Equal));
+                        }
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            const float*
+            AsNumbers(NodeIndex index, std::vector<float>* converted)
+            {
+                if(ast.types[index] != StaticType::Int) { return slots[index].numbers; }
+                if(converted->empty()) { converted->resize(ChunkSize); }
+                Map(slots[index].ints, converted->data(), [](std::int32_t v) { return static_cast<float>(v); });
+                return converted->data();
+            }
+
+            void
+            Run(NodeIndex index, std::size_t begin, std::size_t count)
+            {
+                if(is_constant[index]) { return; }
+
+                const auto& node = ast.GetNode(index);
+                const auto type = ast.types[index];
+                switch(node.type)
+                {
+                case NodeType::Grouping:
+                    slots[index] = slots[node.right];
+                    break;
+                case NodeType::Variable:
+                    RunVariable(index, begin, count);
+                    break;
+                case NodeType::Unary:
+                    if(node.op == TokenType::Not)
+                    {
+                        Map(slots[node.right].bools, Bools(index), [](std::uint8_t v) -> std::uint8_t { return v ^ 1; });
+                    }
+                    else if(type == StaticType::Int)
+                    {
+                        Map(slots[node.right].ints, Ints(index), [](std::int32_t v) { return static_cast<std::int32_t>(0u - static_cast<std::uint32_t>(v)); });
+                    }
+                    else
+                    {
+                        Map(slots[node.right].numbers, Numbers(index), [](float v) { return v * -1; });
+                    }
+                    break;
+                case NodeType::Binary:
+                    RunBinary(index);
+                    break;
+                case NodeType::Literal:
+                    break;
+                }
+            }
+
+            void
+            RunVariable(NodeIndex index, std::size_t begin, std::size_t count)
+            {
+                const auto& column = *columns[program.variable_inputs[ast.GetNode(index).right]];
+
+                // the last chunk is copied so the kernels can run a whole chunk
+                const auto point = [&](const auto& values, auto* buffer, auto* slot)
+                {
+                    if(count == ChunkSize) { *slot = values.data() + begin; }
+                    else { std::copy_n(values.data() + begin, count, buffer); }
+                };
+
+                switch(column.type)
+                {
+                case ColumnType::Int: point(column.ints, Ints(index), &slots[index].ints); break;
+                case ColumnType::Number: point(column.numbers, Numbers(index), &slots[index].numbers); break;
+                case ColumnType::Bool: point(column.bools, Bools(index), &slots[index].bools); break;
+                }
+            }
+
+            void
+            RunBinary(NodeIndex index)
+            {
+                const auto& node = ast.GetNode(index);
+                const auto type = ast.types[index];
+                const auto& lhs = slots[node.left];
+                const auto& rhs = slots[node.right];
+
+                if(type == StaticType::Int)
+                {
+                    auto* result = Ints(index);
+                    switch(node.op)
+                    {
+                    case TokenType::Plus: Zip(lhs.ints, rhs.ints, result, Wrapping(std::plus<>{})); break;
+                    case TokenType::Minus: Zip(lhs.ints, rhs.ints, result, Wrapping(std::minus<>{})); break;
+                    case TokenType::Mult: Zip(lhs.ints, rhs.ints, result, Wrapping(std::multiplies<>{})); break;
+                    case TokenType::Mod: Modulo(lhs.ints, rhs.ints, result, errors.data()); break;
+                    default: assert(false && "unhandled int operator"); break;
+                    }
+                    return;
+                }
+
+                if(type == StaticType::Number)
+                {
+                    const auto* left = AsNumbers(node.left, &buffers[index].left);
+                    const auto* right = AsNumbers(node.right, &buffers[index].right);
+                    auto* result = Numbers(index);
+                    switch(node.op)
+                    {
+                    case TokenType::Plus: Zip(left, right, result, std::plus<>{}); break;
+                    case TokenType::Minus: Zip(left, right, result, std::minus<>{}); break;
+                    case TokenType::Mult: Zip(left, right, result, std::multiplies<>{}); break;
+                    case TokenType::Div: Zip(left, right, result, std::divides<>{}); break;
+                    default: assert(false && "unhandled number operator"); break;
+                    }
+                    return;
+                }
+
+                auto* result = Bools(index);
+                const auto compare = [&](auto operation)
+                {
+                    // ints are compared as numbers like the interpreter does
+                    const auto* left = AsNumbers(node.left, &buffers[index].left);
+                    const auto* right = AsNumbers(node.right, &buffers[index].right);
+                    Zip(left, right, result, [operation](float l, float r) -> std::uint8_t { return operation(l, r) ? 1 : 0; });
+                };
+                const auto equal = [&](bool invert)
+                {
+                    const auto same = [invert](auto l, auto r) -> std::uint8_t { return (l == r) != invert ? 1 : 0; };
+                    if(ast.types[node.left] == StaticType::Int) { Zip(lhs.ints, rhs.ints, result, same); }
+                    else { Zip(lhs.bools, rhs.bools, result, same); }
+                };
+
+                switch(node.op)
+                {
+                case TokenType::Less: compare(std::less<>{}); break;
+                case TokenType::LessEqual: compare(std::less_equal<>{}); break;
+                case TokenType::Greater: compare(std::greater<>{}); break;
+                case TokenType::GreaterEqual: compare(std::greater_equal<>{}); break;
+                case TokenType::Equal: equal(false); break;
+                case TokenType::NotEqual: equal(true); break;
+                default: assert(false && "unhandled bool operator"); break;
+                }
+            }
+        };
+    }
+
+
+    Column
+    Column::FromInts(std::vector<std::int32_t> values)
+    {
+        auto column = Column{};
+        column.type = ColumnType::Int;
+        column.ints = std::move(values);
+        return column;
+    }
+
+
+    Column
+    Column::FromNumbers(std::vector<float> values)
+    {
+        auto column = Column{};
+        column.type = ColumnType::Number;
+        column.numbers = std::move(values);
+        return column;
+    }
+
+
+    Column
+    Column::FromBools(std::vector<std::uint8_t> values)
+    {
+        auto column = Column{};
+        column.type = ColumnType::Bool;
+        column.bools = std::move(values);
+        return column;
+    }
+
+
+    std::size_t
+    Column::GetSize() const
+    {
+        switch(type)
+        {
+        case ColumnType::Int: return ints.size();
+        case ColumnType::Number: return numbers.size();
+        case ColumnType::Bool: return bools.size();
+        }
+        return 0;
+    }
+
+
+    Value
+    Column::GetValue(std::size_t row) const
+    {
+        switch(type)
+        {
+        case ColumnType::Int: return Value::FromInt(ints[row]);
+        case ColumnType::Number: return Value::FromFloat(numbers[row]);
+        case ColumnType::Bool: return Value::FromBool(bools[row] != 0);
+        }
+        return {};
+    }
+
+
+    bool
+    BatchResult::IsError(std::size_t row) const
+    {
+        return (errors[row / 64] >> (row % 64)) & 1;
+    }
+
+
+    std::optional<BatchProgram>
+    CompileBatch(const Ast& ast, const std::vector<BatchInput>& inputs, Log* log)
+    {
+        assert(ast.root != NoNode);
+        auto program = BatchProgram{ast, inputs, {}};
+        bool ok = true;
+
+        VariableTypes types;
+        for(const auto& input: inputs)
+        {
+            types.emplace_back(Intern(input.name), ToStaticType(input.type));
+        }
+
+        for(NodeIndex index = 0; index < ast.nodes.size(); index += 1)
+        {
+            if(ast.GetNode(index).type != NodeType::Variable) { continue; }
+            const auto found = std::find_if(types.begin(), types.end(), [&](const auto& t) { return t.first == ast.GetVariable(index); });
+            if(found == types.end())
+            {
+                log->AddError(ast.GetWhere(index), log::Type::UnknownVariable, {std::string{ast.GetVariable(index)->s}});
+                ok = false;
+            }
+            else
+            {
+                // the ast has one variable for each time it's used
+                program.variable_inputs.emplace_back(static_cast<std::size_t>(found - types.begin()));
+            }
+        }
+
+        if(ok == false || InferTypes(&program.ast, log, types) == false)
+        {
+            return std::nullopt;
+        }
+
+        // strings are only supported as long as nothing needs their value
+        const auto& typed = program.ast;
+        for(NodeIndex index = 0; index < typed.nodes.size(); index += 1)
+        {
+            const auto& node = typed.GetNode(index);
+            const auto is_string_operation = node.type == NodeType::Binary
+                && (typed.types[index] == StaticType::String || typed.types[node.left] == StaticType::String);
+            if(is_string_operation)
+            {
+                log->AddError(typed.GetWhere(index), log::Type::UnsupportedInBatch, {"string"});
+                return std::nullopt;
+            }
+            if(typed.types[index] == StaticType::Unknown)
+            {
+                log->AddError(typed.GetWhere(index), log::Type::UnsupportedInBatch, {"expression"});
+                return std::nullopt;
+            }
+        }
+
+        const auto result = typed.types[typed.root];
+        if(result != StaticType::Int && result != StaticType::Number && result != StaticType::Bool)
+        {
+            log->AddError(typed.GetWhere(typed.root), log::Type::UnsupportedInBatch, {ToString(static_cast<ValueType>(result))});
+            return std::nullopt;
+        }
+
+        return program;
+    }
+
+
+    std::optional<BatchResult>
+    EvaluateBatch(const BatchProgram& program, const std::vector<const Column*>& columns, Log* log)
+    {
+        assert(columns.size() == program.inputs.size());
+        const auto rows = columns.empty() ? 0 : columns[0]->GetSize();
+        for(std::size_t input = 0; input < columns.size(); input += 1)
+        {
+            assert(columns[input]->type == program.inputs[input].type);
+            if(columns[input]->GetSize() != rows)
+            {
+                log->AddError(Where{}, log::Type::ColumnSizeMismatch, {program.inputs[input].name});
+                return std::nullopt;
+            }
+        }
+
+        const auto& ast = program.ast;
+        auto result = BatchResult{};
+        result.errors.resize((rows + 63) / 64, 0);
+        switch(ast.types[ast.root])
+        {
+        case StaticType::Int: result.column = Column::FromInts(std::vector<std::int32_t>(rows)); break;
+        case StaticType::Number: result.column = Column::FromNumbers(std::vector<float>(rows)); break;
+        default: result.column = Column::FromBools(std::vector<std::uint8_t>(rows)); break;
+        }
+
+        auto evaluator = Evaluator{program, columns};
+        for(std::size_t begin = 0; begin < rows; begin += ChunkSize)
+        {
+            const auto count = std::min(ChunkSize, rows - begin);
+            for(NodeIndex index = 0; index < ast.nodes.size(); index += 1)
+            {
+                evaluator.Run(index, begin, count);
+            }
+
+            const auto& root = evaluator.slots[ast.root];
+            switch(result.column.type)
+            {
+            case ColumnType::Int: std::copy_n(root.ints, count, result.column.ints.data() + begin); break;
+            case ColumnType::Number: std::copy_n(root.numbers, count, result.column.numbers.data() + begin); break;
+            case ColumnType::Bool: std::copy_n(root.bools, count, result.column.bools.data() + begin); break;
+            }
+
+            for(std::size_t row = 0; row < count; row += 1)
+            {
+                if(evaluator.errors[row] != 0)
+                {
+                    const auto at = begin + row;
+                    result.errors[at / 64] |= std::uint64_t{1} << (at % 64);
+                }
+            }
+            std::fill(evaluator.errors.begin(), evaluator.errors.end(), 0);
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef FEL_BATCH_H
+#define FEL_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/value.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    enum class ColumnType : std::uint8_t
+    {
+        Int, Number, Bool
+    };
+
+
+    // the values of a input or the result of a batch, only the array of the
+    // type is used
+    struct Column
+    {
+        ColumnType type = ColumnType::Int;
+        std::vector<std::int32_t> ints;
+        std::vector<float> numbers;
+
+        // 0 or 1
+        std::vector<std::uint8_t> bools;
+
+        static Column FromInts(std::vector<std::int32_t> values);
+        static Column FromNumbers(std::vector<float> values);
+        static Column FromBools(std::vector<std::uint8_t> values);
+
+        std::size_t
+        GetSize() const;
+
+        Value
+        GetValue(std::size_t row) const;
+    };
+
+
+    // a variable in the expression that is bound to a column
+    struct BatchInput
+    {
+        std::string name;
+        ColumnType type;
+    };
+
+
+    // a expression compiled to run over columns
+    struct BatchProgram
+    {
+        // a copy of the ast with the types of the columns
+        Ast ast;
+        std::vector<BatchInput> inputs;
+
+        // the index in inputs for each variable in the ast
+        std::vector<std::size_t> variable_inputs;
+    };
+
+
+    struct BatchResult
+    {
+        Column column;
+
+        // a bit for each row that failed, the value of those rows is undefined
+        std::vector<std::uint64_t> errors;
+
+        bool
+        IsError(std::size_t row) const;
+    };
+
+
+    // the variables in the expression are the inputs, it has to be a int,
+    // number or bool when the types of the inputs are known. Strings and
+    // operations that always fail are reported to the log
+    std::optional<BatchProgram>
+    CompileBatch(const Ast& ast, const std::vector<BatchInput>& inputs, Log* log);
+
+
+    // evaluate the program once for each row of the columns, the columns are
+    // in the same order as the inputs and must be the same size. Instead of
+    // logging the rows that fail, like a modulo by zero, they are marked in
+    // the result
+    std::optional<BatchResult>
+    EvaluateBatch(const BatchProgram& program, const std::vector<const Column*>& columns, Log* log);
+}
+
+#endif  // FEL_BATCH_H
@@ -0,0 +1,166 @@
+#include "catch.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/batch.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+
+using namespace fel;
+
+
+namespace
+{
+    std::optional<BatchProgram>
+    Compile(const std::string& source, const std::vector<BatchInput>& inputs, Log* log)
+    {
+        const auto file = File{"source", source};
+        auto parser = Parser{file, log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+        return CompileBatch(*ast, inputs, log);
+    }
+
+
+    // run the source with the variables replaced with the values of the row
+    std::string
+    RunRow(const std::string& source, const std::vector<const Column*>& columns, std::size_t row)
+    {
+        auto text = std::string{};
+        for(const auto c: source)
+        {
+            if(c >= 'x' && c <= 'z') { text += "(" + Stringify(columns[static_cast<std::size_t>(c - 'x')]->GetValue(row)) + ")"; }
+            else { text += c; }
+        }
+
+        Log log;
+        const auto file = File{"source", text};
+        auto parser = Parser{file, &log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+        auto interpreter = Interpreter{&log};
+        return Stringify(interpreter.Evaluate(*ast));
+    }
+}
+
+
+TEST_CASE("batch", "[batch]")
+{
+    // each row should be the same as running the expression with the values
+    // of the row, there are more rows than fit in a chunk
+    const std::vector<std::string> sources =
+    {
+        "x * 3 - y",
+        "(x + 0.5) * y / 2",
+        "x < y == !z",
+        "-x * -(y + 1)",
+        "x == y != (z == true)",
+        "!(x >= 2.5) == (null == null)"
+    };
+    const std::vector<BatchInput> inputs = {{"x", ColumnType::Int}, {"y", ColumnType::Int}, {"z", ColumnType::Bool}};
+
+    const auto rows = std::size_t{1500};
+    auto x = Column::FromInts(std::vector<std::int32_t>(rows));
+    auto y = Column::FromInts(std::vector<std::int32_t>(rows));
+    auto z = Column::FromBools(std::vector<std::uint8_t>(rows));
+    for(std::size_t row = 0; row < rows; row += 1)
+    {
+        x.ints[row] = static_cast<std::int32_t>(row) - 700;
+        y.ints[row] = static_cast<std::int32_t>(row * 7 % 13) - 6;
+        z.bools[row] = row % 3 == 0 ? 1 : 0;
+    }
+    const std::vector<const Column*> columns = {&x, &y, &z};
+
+    for(const auto& source: sources)
+    {
+        CAPTURE(source);
+        Log log;
+        const auto program = Compile(source, inputs, &log);
+        REQUIRE(program);
+        const auto result = EvaluateBatch(*program, columns, &log);
+        REQUIRE(result);
+        CHECK(log.IsEmpty());
+        REQUIRE(result->column.GetSize() == rows);
+
+        for(std::size_t row = 0; row < rows; row += 1)
+        {
+            CAPTURE(row);
+            CHECK_FALSE(result->IsError(row));
+            CHECK(Stringify(result->column.GetValue(row)) == RunRow(source, columns, row));
+        }
+    }
+}
+
+
+TEST_CASE("batch-row-errors", "[batch]")
+{
+    Log log;
+    auto program = Compile("x * y", {{"x", ColumnType::Int}, {"y", ColumnType::Int}}, &log);
+    REQUIRE(program);
+
+    // the parser doesn't know about modulo yet
+    program->ast.nodes[program->ast.root].op = TokenType::Mod;
+
+    const auto x = Column::FromInts({7, 7, -2147483647 - 1, 9});
+    const auto y = Column::FromInts({2, 0, -1, -4});
+    const auto result = EvaluateBatch(*program, {&x, &y}, &log);
+    REQUIRE(result);
+    CHECK(log.IsEmpty());
+
+    CHECK_FALSE(result->IsError(0));
+    CHECK(result->column.ints[0] == 1);
+    CHECK(result->IsError(1));
+    CHECK(result->IsError(2));
+    CHECK_FALSE(result->IsError(3));
+    CHECK(result->column.ints[3] == 1);
+}
+
+
+TEST_CASE("batch-errors", "[batch]")
+{
+    const std::vector<BatchInput> inputs = {{"x", ColumnType::Number}};
+
+    {
+        Log log;
+        CHECK_FALSE(Compile("x + w", inputs, &log));
+        REQUIRE(log.entries.size() == 1);
+        CHECK(log.entries[0].type == log::Type::UnknownVariable);
+        CHECK(log.entries[0].arguments == std::vector<std::string>{"w"});
+    }
+
+    {
+        Log log;
+        CHECK_FALSE(Compile("('a' + 'b') == 'ab'", inputs, &log));
+        REQUIRE(log.entries.size() == 1);
+        CHECK(log.entries[0].type == log::Type::UnsupportedInBatch);
+        CHECK(log.entries[0].arguments == std::vector<std::string>{"string"});
+    }
+
+    {
+        Log log;
+        CHECK_FALSE(Compile("x + true", inputs, &log));
+        CHECK(log.entries.empty() == false);
+        CHECK(log.entries[0].type == log::Type::InvalidBinaryOperation);
+    }
+
+    {
+        Log log;
+        const auto program = Compile("x * 2", inputs, &log);
+        REQUIRE(program);
+        const auto x = Column::FromNumbers({1.0f, 2.0f});
+        const auto wrong = Column::FromNumbers({1.0f});
+        CHECK(EvaluateBatch(*program, {&x}, &log));
+        CHECK(log.IsEmpty());
+
+        auto two = *program;
+        two.inputs.push_back({"w", ColumnType::Number});
+        CHECK_FALSE(EvaluateBatch(two, {&x, &wrong}, &log));
+        REQUIRE(log.entries.size() == 1);
+        CHECK(log.entries[0].type == log::Type::ColumnSizeMismatch);
+    }
+}
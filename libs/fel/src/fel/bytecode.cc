@@ -0,0 +1,175 @@
+#include "fel/bytecode.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "fel/log.h"
+
+namespace fel
+{
+    std::string
+    ToString(OpCode op)
+    {
+        switch(op)
+        {
+            #define X(x) case OpCode::x: return #x
+
+            X(LoadLiteral);
+            X(LoadVariable);
+            X(Add);
+            X(Subtract);
+            X(Multiply);
+            X(Divide);
+            X(Modulo);
+            X(Less);
+            X(LessEqual);
+            X(Greater);
+            X(GreaterEqual);
+            X(Equal);
+            X(NotEqual);
+            X(Negate);
+            X(Not);
+            X(Return);
+
+            #undef X
+
+            default:
+                assert(false && "unhandled case");
+                return "<internal_error>";
+        }
+    }
+
+
+    namespace
+    {
+        constexpr std::size_t MaxRegisters = std::numeric_limits<Register>::max();
+
+
+        std::optional<OpCode>
+        GetBinaryOpCode(TokenType type)
+        {
+            switch(type)
+            {
+            case TokenType::Plus: return OpCode::Add;
+            case TokenType::Minus: return OpCode::Subtract;
+            case TokenType::Mult: return OpCode::Multiply;
+            case TokenType::Div: return OpCode::Divide;
+            case TokenType::Mod: return OpCode::Modulo;
+            case TokenType::Less: return OpCode::Less;
+            case TokenType::LessEqual: return OpCode::LessEqual;
+            case TokenType::Greater: return OpCode::Greater;
+            case TokenType::GreaterEqual: return OpCode::GreaterEqual;
+            case TokenType::Equal: return OpCode::Equal;
+            case TokenType::NotEqual: return OpCode::NotEqual;
+            default: return std::nullopt;
+            }
+        }
+
+
+        std::optional<OpCode>
+        GetUnaryOpCode(TokenType type)
+        {
+            switch(type)
+            {
+            case TokenType::Minus: return OpCode::Negate;
+            case TokenType::Not: return OpCode::Not;
+            default: return std::nullopt;
+            }
+        }
+
+
+        struct Compiler
+        {
+            const Ast& ast;
+            Code* code;
+            Log* log;
+            bool failed = false;
+
+            void
+            Add(NodeIndex node, OpCode op, std::size_t dst, std::size_t a, std::size_t b)
+            {
+                code->instructions.emplace_back(Instruction{op, static_cast<Register>(dst), static_cast<Register>(a), static_cast<Register>(b)});
+                code->nodes.emplace_back(node);
+            }
+
+            // compile the node so the result ends up in the target register
+            void
+            Compile(NodeIndex index, std::size_t target)
+            {
+                if(failed) { return; }
+                if(target >= MaxRegisters)
+                {
+                    log->AddError(ast.GetWhere(index), log::Type::ExpressionTooComplex, {});
+                    failed = true;
+                    return;
+                }
+                code->register_count = std::max(code->register_count, target + 1);
+
+                const auto& node = ast.GetNode(index);
+                switch(node.type)
+                {
+                case NodeType::Binary:
+                    Compile(node.left, target);
+                    Compile(node.right, target + 1);
+                    if(const auto op = GetBinaryOpCode(node.op); op)
+                    {
+                        Add(index, *op, target, target, target + 1);
+                    }
+                    else
+                    {
+                        log->AddError(FEL_WHERE_HERE, log::Type::InternalError, {"unhandled case in binary switch"});
+                        failed = true;
+                    }
+                    break;
+                case NodeType::Grouping:
+                    Compile(node.right, target);
+                    break;
+                case NodeType::Literal:
+                    Add(index, OpCode::LoadLiteral, target, node.right & 0xffff, node.right >> 16);
+                    break;
+                case NodeType::Unary:
+                    Compile(node.right, target);
+                    if(const auto op = GetUnaryOpCode(node.op); op)
+                    {
+                        Add(index, *op, target, target, 0);
+                    }
+                    else
+                    {
+                        log->AddError(FEL_WHERE_HERE, log::Type::InternalError, {"unhandled case in unary switch"});
+                        failed = true;
+                    }
+                    break;
+                case NodeType::Variable:
+                    // reported when run, see fel/batch.h for binding variables
+                    Add(index, OpCode::LoadVariable, target, 0, 0);
+                    break;
+                default:
+                    log->AddError(FEL_WHERE_HERE, log::Type::InternalError, {"unhandled case in node switch"});
+                    failed = true;
+                    break;
+                }
+            }
+        };
+    }
+
+
+    std::optional<Code>
+    Compile(const Ast& ast, Log* log)
+    {
+        Code code;
+        code.ast = &ast;
+        code.instructions.reserve(ast.nodes.size() + 1);
+        code.nodes.reserve(ast.nodes.size() + 1);
+
+        auto compiler = Compiler{ast, &code, log};
+        compiler.Compile(ast.root, 0);
+        if(compiler.failed)
+        {
+            return std::nullopt;
+        }
+
+        compiler.Add(ast.root, OpCode::Return, 0, 0, 0);
+        return code;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef FEL_BYTECODE_H
+#define FEL_BYTECODE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    enum class OpCode : std::uint8_t
+    {
+        // dst = the literal at a | b << 16
+        LoadLiteral,
+
+        // dst = null, nothing binds variables when running code so it's
+        // reported like the interpreter does
+        LoadVariable,
+
+        // dst = a op b
+        Add, Subtract, Multiply, Divide, Modulo,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+
+        // dst = op a
+        Negate, Not,
+
+        // the result is a
+        Return
+    };
+
+
+    std::string
+    ToString(OpCode op);
+
+
+    using Register = std::uint16_t;
+
+
+    struct Instruction
+    {
+        OpCode op;
+        Register dst;
+        Register a;
+        Register b;
+    };
+
+
+    static_assert(sizeof(Instruction) == 8, "instructions should be kept small");
+
+
+    // the compiled expression, it refers to the ast for the literals and the
+    // locations of the errors so the ast must outlive it
+    struct Code
+    {
+        const Ast* ast = nullptr;
+        std::vector<Instruction> instructions;
+
+        // the node each instruction was compiled from
+        std::vector<NodeIndex> nodes;
+
+        std::size_t register_count = 0;
+    };
+
+
+    // compile to a register machine, every node writes to the lowest free
+    // register so a long chain of binary operators needs few registers
+    std::optional<Code>
+    Compile(const Ast& ast, Log* log);
+}
+
+#endif  // FEL_BYTECODE_H
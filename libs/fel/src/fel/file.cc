@@ -6,15 +6,132 @@
 
 #include <cassert>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace fel
 {
-    File::File(const std::string& a_filename, const std::string& a_content)
+    namespace
+    {
+        std::shared_ptr<const std::string>
+        Own(std::string content)
+        {
+            return std::make_shared<const std::string>(std::move(content));
+        }
+
+
+        std::optional<File>
+        ReadWholeFile(const std::string& path)
+        {
+            auto stream = std::ifstream{path.c_str(), std::ios::binary};
+            if(!stream.good())
+            {
+                return std::nullopt;
+            }
+
+            return ReadStream(path, stream);
+        }
+    }
+
+
+    File::File(const std::string& a_filename, std::string a_content)
         : filename(a_filename)
-        , data(a_content)
     {
+        auto owned = Own(std::move(a_content));
+        data = *owned;
+        storage = std::move(owned);
+        lines = std::make_shared<const LineIndex>(data);
+        registration = RegisterFile(filename, lines);
+        id = *registration;
     }
 
 
+    File::File
+    (
+        const std::string& a_filename,
+        std::string_view a_data,
+        std::shared_ptr<const void> a_storage
+    )
+        : filename(a_filename)
+        , data(a_data)
+        , storage(std::move(a_storage))
+        , lines(std::make_shared<const LineIndex>(a_data))
+        , registration(RegisterFile(a_filename, lines))
+        , id(*registration)
+    {
+    }
+
+
+    File
+    ReadStream(const std::string& filename, std::istream& stream)
+    {
+        std::string content;
+        char buffer[4096];
+        while(stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0)
+        {
+            content.append(buffer, static_cast<std::size_t>(stream.gcount()));
+        }
+        return File{filename, std::move(content)};
+    }
+
+
+#ifdef _WIN32
+    std::optional<File>
+    MapFile(const std::string& path)
+    {
+        // todo(Gustav): use CreateFileMapping on windows
+        return ReadWholeFile(path);
+    }
+#else
+    std::optional<File>
+    MapFile(const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if(fd == -1)
+        {
+            return std::nullopt;
+        }
+
+        struct stat info;
+        if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+        {
+            // pipes, devices and such can't be mapped
+            close(fd);
+            return ReadWholeFile(path);
+        }
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        if(size == 0)
+        {
+            close(fd);
+            return File{path, std::string{}};
+        }
+
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if(mapped == MAP_FAILED)
+        {
+            return ReadWholeFile(path);
+        }
+
+        madvise(mapped, size, MADV_SEQUENTIAL);
+
+        auto storage = std::shared_ptr<const void>
+        (
+            mapped,
+            [size](const void* p) { munmap(const_cast<void*>(p), size); }
+        );
+        const auto data = std::string_view{static_cast<const char*>(mapped), size};
+        return File{path, data, std::move(storage)};
+    }
+#endif
+
+
     FilePointer::FilePointer(const File& a_file)
         : file(a_file)
     {
@@ -28,6 +145,13 @@ namespace fel
     }
 
 
+    Location
+    FilePointer::GetLocation() const
+    {
+        return file.lines->GetLocation(next_index);
+    }
+
+
     char
     FilePointer::Read()
     {
@@ -35,15 +159,6 @@ namespace fel
         {
             const auto read = file.data[next_index];
             next_index += 1;
-            if(read == '\n')
-            {
-                location.line += 1;
-                location.column = 0;
-            }
-            else
-            {
-                location.column += 1;
-            }
             return read;
         }
         else
@@ -53,6 +168,13 @@ namespace fel
     }
 
 
+    void
+    FilePointer::SkipTo(std::size_t index)
+    {
+        next_index = index;
+    }
+
+
     char
     FilePointer::Peek(std::size_t advance) const
     {
@@ -2,35 +2,86 @@
 #define FEL_FILE_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <memory>
 #include <optional>
 
+#include "fel/filetable.h"
+#include "fel/lineindex.h"
 #include "fel/location.h"
 
 namespace fel
 {
+    // tokens store offsets in 32 bits, larger files are reported by the
+    // lexer instead of being lexed
+    constexpr std::size_t MaxFileSize = std::numeric_limits<std::uint32_t>::max();
+
+
     struct File
     {
         std::string filename;
-        std::string data;
 
-        File(const std::string& a_filename, const std::string& a_content);
+        // read-only view of the source, valid as long as any copy of this
+        // file is alive
+        std::string_view data;
+
+        // keeps the memory behind data alive, either a owned string or a
+        // memory mapped file
+        std::shared_ptr<const void> storage;
+
+        // resolves offsets to lines and columns when needed
+        std::shared_ptr<const LineIndex> lines;
+
+        // the entry in the file table, shared by all copies and released
+        // with the last of them
+        FileRegistration registration;
+        FileId id;
+
+        // owning fallback, used for code from the commandline and stdin
+        File(const std::string& a_filename, std::string a_content);
+
+        File
+        (
+            const std::string& a_filename,
+            std::string_view a_data,
+            std::shared_ptr<const void> a_storage
+        );
     };
 
 
+    // reads everything into a owned file, used for stdin
+    File
+    ReadStream(const std::string& filename, std::istream& stream);
+
+
+    // memory maps the file if possible, reads it into memory if not
+    std::optional<File>
+    MapFile(const std::string& path);
+
+
     struct FilePointer
     {
         const File& file;
-        std::string::size_type next_index = 0;
-        Location location = Location {1, 0};
+        std::string_view::size_type next_index = 0;
 
         explicit FilePointer(const File& file);
 
+        // only resolved when needed, like when reporting errors
+        Location
+        GetLocation() const;
+
         bool
         HasMore() const;
 
         char
         Read();
 
+        void
+        SkipTo(std::size_t index);
+
         // 1 is next character, 2 is the one after that...
         char
         Peek(std::size_t = 1) const;
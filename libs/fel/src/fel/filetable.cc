@@ -0,0 +1,292 @@
+#include "fel/filetable.h"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <cassert>
+
+#include "fel/lineindex.h"
+
+namespace fel
+{
+    namespace
+    {
+        // a id is the index of the entry and the generation of the entry
+        // when it was given out, the generation changes when a entry is
+        // released so old ids can be told apart from the new file
+        constexpr int kIndexBits = 24;
+        constexpr FileId kIndexMask = (FileId{1} << kIndexBits) - 1;
+
+        std::uint32_t
+        GetIndex(FileId id)
+        {
+            return id & kIndexMask;
+        }
+
+        std::uint32_t
+        GetGeneration(FileId id)
+        {
+            return id >> kIndexBits;
+        }
+
+
+        // the fields that are read without the lock are sequentially
+        // consistent atomics. A reader checks the generation after reading
+        // them, if it changed the entry was released while reading
+        struct FileEntry
+        {
+            std::atomic<std::uint32_t> generation {0};
+            std::atomic<const char*> data {nullptr};
+            std::atomic<std::size_t> size {0};
+
+            // names are interned and shared between all files with the same
+            // name, the name is kept until the entry is given out again
+            std::atomic<const std::string*> name {nullptr};
+            std::atomic<std::uint32_t> name_generation {0};
+
+            // only used with the lock held
+            std::weak_ptr<const LineIndex> lines;
+        };
+
+
+        // entries are stored in chunks that are never moved so lookups can
+        // be done without taking the lock, only registering needs it
+        constexpr std::size_t kChunkSize = 1024;
+        constexpr std::size_t kMaxChunks = (std::size_t{1} << kIndexBits) / kChunkSize;
+
+        // a released entry waits for this many others before it's reused, so
+        // a id has to outlive a lot of files before the generation wraps
+        // around and it points to a new file
+        constexpr std::size_t kMinimumFreeEntries = 4096;
+
+        struct FileTable
+        {
+            std::mutex mutex;
+            std::uint32_t next_index = 0;
+            std::array<std::atomic<FileEntry*>, kMaxChunks> chunks = {};
+
+            // released entries, the oldest is given out first so the name of
+            // a released file is kept as long as possible
+            std::deque<std::uint32_t> free_entries;
+
+            std::unordered_set<std::string> names;
+            std::unordered_map<std::string_view, FileId> name_only_files;
+
+            FileTable()
+            {
+                const auto undefined = Add("<undefined>", nullptr);
+                assert(undefined == UndefinedFile);
+                (void)undefined;
+            }
+
+            FileEntry&
+            GetEntry(std::uint32_t index)
+            {
+                return chunks[index / kChunkSize].load(std::memory_order_relaxed)[index % kChunkSize];
+            }
+
+            // assumes the lock is held
+            FileId
+            Add(const std::string& name, std::shared_ptr<const LineIndex> lines)
+            {
+                std::uint32_t index = 0;
+                const auto is_full = next_index == kMaxChunks * kChunkSize;
+                if(free_entries.size() > kMinimumFreeEntries || (is_full && !free_entries.empty()))
+                {
+                    index = free_entries.front();
+                    free_entries.pop_front();
+                }
+                else if(!is_full)
+                {
+                    index = next_index;
+                    next_index += 1;
+
+                    auto& slot = chunks[index / kChunkSize];
+                    if(slot.load(std::memory_order_relaxed) == nullptr)
+                    {
+                        slot.store(new FileEntry[kChunkSize], std::memory_order_release);
+                    }
+                }
+                else
+                {
+                    throw std::length_error("too many files are open");
+                }
+
+                auto& entry = GetEntry(index);
+                const auto generation = entry.generation.load();
+                const auto data = lines ? lines->data : std::string_view{};
+                entry.data.store(data.data());
+                entry.size.store(data.size());
+
+                // old ids see the new generation before the new name
+                entry.name_generation.store(generation);
+                entry.name.store(&*names.emplace(name).first);
+                entry.lines = std::move(lines);
+                return index | (generation << kIndexBits);
+            }
+
+            // assumes the lock is held
+            void
+            Release(FileId id)
+            {
+                auto& entry = GetEntry(GetIndex(id));
+                assert(entry.generation.load(std::memory_order_relaxed) == GetGeneration(id));
+
+                const auto next_generation = (GetGeneration(id) + 1) & (FileId{0xffffffff} >> kIndexBits);
+                entry.generation.store(next_generation);
+                entry.lines.reset();
+                free_entries.emplace_back(GetIndex(id));
+            }
+
+            ~FileTable()
+            {
+                for(auto& c: chunks)
+                {
+                    delete[] c.load();
+                }
+            }
+        };
+
+
+        FileTable&
+        GetTable()
+        {
+            static FileTable table;
+            return table;
+        }
+
+
+        const FileEntry&
+        GetEntry(FileId file)
+        {
+            auto& table = GetTable();
+            const auto index = GetIndex(file);
+            const auto* chunk = table.chunks[index / kChunkSize].load(std::memory_order_acquire);
+            assert(chunk != nullptr);
+            return chunk[index % kChunkSize];
+        }
+
+
+        // the entry was given out to another file while it was read
+        bool
+        IsChanged(const std::atomic<std::uint32_t>& generation, FileId file)
+        {
+            return generation.load() != GetGeneration(file);
+        }
+
+
+        std::shared_ptr<const LineIndex>
+        GetLines(FileId file)
+        {
+            auto& table = GetTable();
+            std::lock_guard<std::mutex> lock{table.mutex};
+            const auto& entry = GetEntry(file);
+            if(entry.generation.load(std::memory_order_relaxed) != GetGeneration(file))
+            {
+                return nullptr;
+            }
+            return entry.lines.lock();
+        }
+    }
+
+
+    FileRegistration
+    RegisterFile(const std::string& name, std::shared_ptr<const LineIndex> lines)
+    {
+        auto& table = GetTable();
+        std::lock_guard<std::mutex> lock{table.mutex};
+        const auto id = table.Add(name, std::move(lines));
+        return FileRegistration
+        {
+            new FileId{id},
+            [](const FileId* released)
+            {
+                auto& t = GetTable();
+                {
+                    std::lock_guard<std::mutex> l{t.mutex};
+                    t.Release(*released);
+                }
+                delete released;
+            }
+        };
+    }
+
+
+    FileId
+    InternFileName(const std::string& name)
+    {
+        auto& table = GetTable();
+        std::lock_guard<std::mutex> lock{table.mutex};
+
+        if(const auto found = table.name_only_files.find(name); found != table.name_only_files.end())
+        {
+            return found->second;
+        }
+
+        // never released
+        const auto id = table.Add(name, nullptr);
+        table.name_only_files.emplace(*GetEntry(id).name.load(std::memory_order_relaxed), id);
+        return id;
+    }
+
+
+    const std::string&
+    GetFileName(FileId file)
+    {
+        static const std::string released = "<released>";
+
+        const auto& entry = GetEntry(file);
+        const auto* name = entry.name.load();
+        if(IsChanged(entry.name_generation, file) || name == nullptr)
+        {
+            return released;
+        }
+        return *name;
+    }
+
+
+    std::string_view
+    GetFileData(FileId file)
+    {
+        const auto& entry = GetEntry(file);
+        if(entry.generation.load() != GetGeneration(file))
+        {
+            return {};
+        }
+
+        const auto* data = entry.data.load();
+        const auto size = entry.size.load();
+        if(IsChanged(entry.generation, file))
+        {
+            return {};
+        }
+        return {data, size};
+    }
+
+
+    Location
+    GetLocation(FileId file, std::size_t offset)
+    {
+        if(const auto lines = GetLines(file); lines)
+        {
+            return lines->GetLocation(offset);
+        }
+        return {};
+    }
+
+
+    Location
+    GetUtf16Location(FileId file, std::size_t offset)
+    {
+        if(const auto lines = GetLines(file); lines)
+        {
+            return lines->GetUtf16Location(offset);
+        }
+        return {};
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef FEL_FILETABLE_H
+#define FEL_FILETABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "fel/location.h"
+
+namespace fel
+{
+    struct LineIndex;
+
+    // small handle to a entry in the process wide file table
+    using FileId = std::uint32_t;
+
+
+    // reserved id for locations that doesn't point to any file
+    constexpr FileId UndefinedFile = 0;
+
+
+    // keeps a file in the table, the entry is released with the last copy
+    // and the id may then be given to another file
+    using FileRegistration = std::shared_ptr<const FileId>;
+
+
+    // throws std::length_error if there are too many files alive at once
+    FileRegistration
+    RegisterFile(const std::string& name, std::shared_ptr<const LineIndex> lines);
+
+
+    // get the id of a file without any data, like a c++ source file,
+    // returns the same id for the same name
+    FileId
+    InternFileName(const std::string& name);
+
+
+    // the name stays until the id is given to another file
+    const std::string&
+    GetFileName(FileId file);
+
+
+    // empty if the file is gone, the data is only valid as long as the file
+    // is alive
+    std::string_view
+    GetFileData(FileId file);
+
+
+    // resolves a offset in the file, returns a invalid location if the file
+    // has no data or is gone
+    Location
+    GetLocation(FileId file, std::size_t offset);
+
+
+    Location
+    GetUtf16Location(FileId file, std::size_t offset);
+}
+
+#endif  // FEL_FILETABLE_H
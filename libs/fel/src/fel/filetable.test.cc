@@ -0,0 +1,40 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "fel/file.h"
+#include "fel/filetable.h"
+
+using namespace fel;
+
+
+TEST_CASE("filetable-release", "[filetable]")
+{
+    FileId id = UndefinedFile;
+    {
+        const auto file = File{"released", std::string{"1 + 2"}};
+        id = file.id;
+        const auto copy = file;
+        CHECK(GetFileData(id) == "1 + 2");
+        CHECK(GetLocation(id, 4).column == 4);
+    }
+
+    // the name is kept for errors that are printed after the file is gone
+    CHECK(GetFileData(id).empty());
+    CHECK(GetLocation(id, 4).line == -1);
+    CHECK(GetFileName(id) == "released");
+
+    // released entries are reused, the old id doesn't see the new file
+    std::vector<FileId> ids;
+    for(int i = 0; i < 10000; i += 1)
+    {
+        const auto file = File{"new", std::string{"abc"}};
+        ids.emplace_back(file.id);
+        CHECK(GetFileData(file.id) == "abc");
+    }
+    CHECK(std::find(ids.begin(), ids.end(), id) == ids.end());
+    CHECK(GetFileData(id).empty());
+    CHECK(GetFileName(id) == "<released>");
+}
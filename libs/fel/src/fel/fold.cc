@@ -0,0 +1,108 @@
+#include "fel/fold.h"
+
+#include <optional>
+#include <vector>
+
+#include "fel/interpreter.h"
+#include "fel/log.h"
+
+namespace fel
+{
+    Ast
+    FoldConstants(const Ast& ast)
+    {
+        const auto count = static_cast<NodeIndex>(ast.nodes.size());
+
+        // children are before their parents so a single pass folds the
+        // whole tree from the bottom up
+        std::vector<std::optional<Value>> values(count);
+        Log log;
+        for(NodeIndex index = 0; index < count; index += 1)
+        {
+            const auto& node = ast.GetNode(index);
+            switch(node.type)
+            {
+            case NodeType::Literal:
+                values[index] = ast.GetLiteral(index);
+                break;
+            case NodeType::Grouping:
+                values[index] = values[node.right];
+                break;
+            case NodeType::Unary:
+                if(values[node.right])
+                {
+                    auto value = EvaluateUnaryOperation(&log, ast, index, *values[node.right]);
+                    if(log.IsEmpty()) { values[index] = std::move(value); }
+                }
+                break;
+            case NodeType::Binary:
+                if(values[node.left] && values[node.right])
+                {
+                    // no arena, the value is stored in the new ast
+                    auto value = EvaluateBinaryOperation(&log, nullptr, ast, index, *values[node.left], *values[node.right]);
+                    if(log.IsEmpty()) { values[index] = std::move(value); }
+                }
+                break;
+            case NodeType::Variable:
+                break;
+            }
+            log.entries.clear();
+        }
+
+        // only keep the nodes that are still used, the children of a folded
+        // node are not
+        std::vector<bool> is_used(count, false);
+        if(ast.root != NoNode) { is_used[ast.root] = true; }
+        for(auto index = count; index > 0; index -= 1)
+        {
+            const auto& node = ast.GetNode(index - 1);
+            if(is_used[index - 1] == false || values[index - 1]) { continue; }
+            if(node.type == NodeType::Variable) { continue; }
+            if(node.type == NodeType::Binary) { is_used[node.left] = true; }
+            is_used[node.right] = true;
+        }
+
+        auto folded = Ast{};
+        folded.file = ast.file;
+        folded.source = ast.source;
+        std::vector<NodeIndex> remap(count, NoNode);
+        for(NodeIndex index = 0; index < count; index += 1)
+        {
+            if(is_used[index] == false) { continue; }
+
+            const auto& node = ast.GetNode(index);
+            if(values[index])
+            {
+                // a prepared program shares the literals between threads
+                // so a folded concatenation is joined now
+                values[index]->Flatten();
+
+                // the token the expression started with so errors still
+                // point to the same place
+                remap[index] = folded.AddLiteral(*values[index], ast.GetToken(ast.GetFirstNode(index)));
+                continue;
+            }
+
+            switch(node.type)
+            {
+            case NodeType::Binary:
+                remap[index] = folded.AddBinary(remap[node.left], ast.GetToken(index), remap[node.right]);
+                break;
+            case NodeType::Grouping:
+                remap[index] = folded.AddGrouping(remap[node.right]);
+                break;
+            case NodeType::Unary:
+                remap[index] = folded.AddUnary(ast.GetToken(index), remap[node.right]);
+                break;
+            case NodeType::Variable:
+                remap[index] = folded.AddVariable(ast.GetVariable(index), ast.GetToken(index));
+                break;
+            case NodeType::Literal:
+                break;
+            }
+        }
+
+        if(ast.root != NoNode) { folded.root = remap[ast.root]; }
+        return folded;
+    }
+}
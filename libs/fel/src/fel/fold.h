@@ -0,0 +1,16 @@
+#ifndef FEL_FOLD_H
+#define FEL_FOLD_H
+
+#include "fel/ast.h"
+
+namespace fel
+{
+    // a copy of the ast where expressions of only literals are replaced by
+    // their value. The value keeps the location of the expression and
+    // expressions that would fail are kept so the errors are reported
+    // when it's run
+    Ast
+    FoldConstants(const Ast& ast);
+}
+
+#endif  // FEL_FOLD_H
@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/ast_printer.h"
+#include "fel/file.h"
+#include "fel/fold.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+
+using namespace fel;
+
+
+TEST_CASE("fold", "[fold]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"(60 * 60 * 24) + -(1.5 * 2)"}};
+    auto parser = Parser{file, &log};
+    const auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    const auto folded = FoldConstants(*ast);
+    REQUIRE(folded.nodes.size() == 1);
+    CHECK(folded.GetNode(folded.root).type == NodeType::Literal);
+    CHECK(AstPrinter{}.Print(folded) == "86397");
+    CHECK(folded.GetWhere(folded.root) == ast->GetWhere(ast->root));
+}
+
+
+TEST_CASE("fold-errors", "[fold]")
+{
+    // errors aren't folded and are reported at the same place as before
+    const std::vector<std::string> sources =
+    {
+        "(1 + 2) + null", "2 * (3 + 'a')", "-'a' + 1", "(1 < 2) == ('a' + 'b' == 'ab')"
+    };
+
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+
+        Log parse_log;
+        auto parser = Parser{file, &parse_log};
+        const auto ast = parser.Parse();
+        REQUIRE(ast);
+
+        Log expected_log;
+        const auto expected = Interpreter{&expected_log}.Evaluate(*ast);
+
+        const auto folded = FoldConstants(*ast);
+        Log folded_log;
+        const auto result = Interpreter{&folded_log}.Evaluate(folded);
+
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(folded_log.entries == expected_log.entries);
+    }
+}
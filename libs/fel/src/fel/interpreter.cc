@@ -1,6 +1,10 @@
 #include "fel/interpreter.h"
 
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 
 #include "fel/log.h"
 
@@ -8,36 +12,26 @@
 namespace fel
 {
     bool
-    IsTruthy(std::shared_ptr<Object> obj)
+    IsTruthy(const Value& value)
     {
+        switch(value.GetType())
+        {
         // null is falsy
-        if(obj == nullptr) { return false;}
+        case ValueType::Null: return false;
 
         // false is falsy (true is true)
-        if(obj->GetType() == ObjectType::Bool)
-        {
-            return static_cast<BoolObject*>(obj.get())->b;
-        }
+        case ValueType::Bool: return value.AsBool();
 
         // all others are true
-        return true;
+        default: return true;
+        }
     }
 
     std::string
-    TypeToString(std::shared_ptr<Object> object)
+    TypeToString(const Value& value)
     {
-        if(object == nullptr) { return "null";}
-        switch(object->GetType())
-        {
-            // todo(Gustav): add the value here?
-            case ObjectType::Bool: return "bool";
-            case ObjectType::Int: return "int";
-            case ObjectType::Number: return "number";
-            case ObjectType::String: return "string";
-            default:
-                assert(false && "unhandled case");
-                return "<internal_error>";
-        }
+        // todo(Gustav): add the value here?
+        return ToString(value.GetType());
     }
 
 
@@ -47,342 +41,358 @@ namespace fel
     }
 
 
-    bool CanCastToNumber(std::shared_ptr<Object> object)
+    namespace
     {
-        const auto type = object->GetType();
-        return type == ObjectType::Int || type == ObjectType::Number;
-    }
+        // the operators in the order of the kernel table
+        enum class BinaryOperator : std::uint8_t
+        {
+            Add, Subtract, Multiply, Divide, Modulo,
+            Less, LessEqual, Greater, GreaterEqual,
+            Equal, NotEqual,
 
-    float CastToNumber(std::shared_ptr<Object> object)
-    {
-        const auto type = object->GetType();
-        if(type == ObjectType::Int)
+            // a token that isn't a binary operator, reported as a internal error
+            Unhandled
+        };
+
+        constexpr std::size_t BinaryOperatorCount = static_cast<std::size_t>(BinaryOperator::Unhandled) + 1;
+        constexpr std::size_t ValueTypeCount = static_cast<std::size_t>(ValueType::String) + 1;
+
+
+        // what a kernel needs to report a error, the arena is for strings
+        struct OperationContext
         {
-            return static_cast<float>(static_cast<IntObject*>(object.get())->i);
-        }
-        if(type == ObjectType::Number)
+            Log* log;
+            Arena* arena;
+            const Ast& ast;
+            NodeIndex index;
+        };
+
+        using BinaryKernel = Value (*)(const OperationContext& context, const Value& left, const Value& right);
+
+
+        // the kernel and the type it returns, errors return Unknown
+        struct BinaryOperation
+        {
+            BinaryKernel kernel;
+            StaticType type;
+        };
+
+
+        float
+        CastToNumber(const Value& value)
         {
-            return static_cast<FloatObject*>(object.get())->f;
+            if(value.GetType() == ValueType::Int)
+            {
+                return static_cast<float>(value.AsInt());
+            }
+            return value.AsNumber();
         }
-        assert(false && "invalid number type");
-        return 0.0f;
-    }
 
 
-    std::shared_ptr<Object>
-    BinaryHelper 
-    (
-        Log* log,
-        const Token& op,
-        std::shared_ptr<Expression> lhs,
-        std::shared_ptr<Expression> rhs,
-        std::shared_ptr<Object> left,
-        std::shared_ptr<Object> right,
-        std::optional<std::function<int (int, int)>> int_function,
-        std::optional<std::function<float (float, float)>> number_function,
-        std::optional
-        <
-            std::function
-            <
-                std::optional<std::shared_ptr<Object>>
-                (
-                    std::shared_ptr<Object>,
-                    std::shared_ptr<Object>
-                )
-            >
-        > fallback_function = std::nullopt
-    )
-    {
-        if(left == nullptr || right == nullptr)
+        void
+        AddOperandErrors(const OperationContext& context, log::Type type, const Value& left, const Value& right)
         {
-            log->AddError(op.where, log::Type::InvalidOperationOnNull, {op.lexeme});
-            log->AddError(lhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
-            log->AddError(rhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
-            return nullptr;
+            const auto& node = context.ast.GetNode(context.index);
+            const auto op = context.ast.GetToken(context.index);
+            context.log->AddError(op.GetWhere(), type, {std::string{op.GetLexeme()}});
+            context.log->AddError(context.ast.GetWhere(node.left), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
+            context.log->AddError(context.ast.GetWhere(node.right), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
         }
 
-        if(int_function)
+
+        // ------------------------------------------------------------------------
+        // the kernels, one is picked for each operator and pair of types
+
+        Value
+        NullKernel(const OperationContext& context, const Value& left, const Value& right)
         {
-            if(left->GetType() == ObjectType::Int && right->GetType() == ObjectType::Int)
-            {
-                return Object::FromInt((*int_function)
-                (
-                    static_cast<IntObject*>(left.get())->i,
-                    static_cast<IntObject*>(right.get())->i
-                ));
-            }
+            AddOperandErrors(context, log::Type::InvalidOperationOnNull, left, right);
+            return {};
         }
 
-        
+        Value
+        InvalidKernel(const OperationContext& context, const Value& left, const Value& right)
+        {
+            AddOperandErrors(context, log::Type::InvalidBinaryOperation, left, right);
+            return {};
+        }
 
-        if(number_function && CanCastToNumber(left) && CanCastToNumber(right))
+        Value
+        UnhandledKernel(const OperationContext& context, const Value&, const Value&)
         {
-            return Object::FromFloat
+            context.log->AddError
             (
-                (*number_function)(CastToNumber(left), CanCastToNumber(right))
+                FEL_WHERE_HERE,
+                log::Type::InternalError,
+                {"unhandled case in binary switch"}
             );
+            return {};
+        }
+
+        template<typename Operation>
+        Value
+        IntKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromInt(WrapInt(Operation{}, left.AsInt(), right.AsInt()));
         }
 
-        if(fallback_function)
+        Value
+        ModuloKernel(const OperationContext& context, const Value& left, const Value& right)
         {
-            auto fallback_value = (*fallback_function)(left, right);
-            if(fallback_value)
+            if(!IsDefinedModulo(left.AsInt(), right.AsInt()))
             {
-                return *fallback_value;
+                AddOperandErrors(context, log::Type::UndefinedModulo, left, right);
+                return {};
             }
+            return Value::FromInt(left.AsInt() % right.AsInt());
         }
 
-        log->AddError(op.where, log::Type::InvalidBinaryOperation, {op.lexeme});
-        log->AddError(lhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
-        log->AddError(rhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
-        return nullptr;
-    }
+        template<typename Operation>
+        Value
+        NumberKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromFloat(Operation{}(CastToNumber(left), CastToNumber(right)));
+        }
 
+        template<typename Operation>
+        Value
+        CompareKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromBool(Operation{}(CastToNumber(left), CastToNumber(right)));
+        }
 
-    std::shared_ptr<Object>
-    CompareHelper 
-    (
-        Log* log,
-        const Token& op,
-        std::shared_ptr<Expression> lhs,
-        std::shared_ptr<Expression> rhs,
-        std::shared_ptr<Object> left,
-        std::shared_ptr<Object> right,
-        std::function<bool (float, float)> compare_function
-    )
-    {
-        if(left == nullptr || right == nullptr)
+        Value
+        ConcatKernel(const OperationContext& context, const Value& left, const Value& right)
         {
-            log->AddError(op.where, log::Type::InvalidOperationOnNull, {op.lexeme});
-            log->AddError(lhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
-            log->AddError(rhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
-            return nullptr;
+            return Value::Concat(left, right, context.arena);
         }
 
-        
-        if(CanCastToNumber(left) && CanCastToNumber(right))
+        template<bool Result>
+        Value
+        ConstantKernel(const OperationContext&, const Value&, const Value&)
         {
-            return Object::FromBool
-            (
-                compare_function(CastToNumber(left), CanCastToNumber(right))
-            );
+            return Value::FromBool(Result);
+        }
+
+        template<bool Invert>
+        Value
+        EqualBoolKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromBool(Invert != (left.AsBool() == right.AsBool()));
         }
 
-        // todo(Gustav): allow comparing of strings?
+        template<bool Invert>
+        Value
+        EqualIntKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromBool(Invert != (left.AsInt() == right.AsInt()));
+        }
 
-        log->AddError(op.where, log::Type::InvalidBinaryOperation, {op.lexeme});
-        log->AddError(lhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
-        log->AddError(rhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
-        return nullptr;
-    }
+        template<bool Invert>
+        Value
+        EqualStringKernel(const OperationContext&, const Value& left, const Value& right)
+        {
+            return Value::FromBool(Invert != IsSameString(left, right));
+        }
 
 
-    std::shared_ptr<Object>
-    EqualHelper 
-    (
-        Log* log,
-        const Token& op,
-        std::shared_ptr<Expression> lhs,
-        std::shared_ptr<Expression> rhs,
-        std::shared_ptr<Object> left,
-        std::shared_ptr<Object> right,
-        bool invert_result
-    )
-    {
-        if(left == nullptr && right == nullptr) { return Object::FromBool(true); }
-        if(left == nullptr || right == nullptr) { return Object::FromBool(false); }
+        // ------------------------------------------------------------------------
+        // the table is built when compiling so evaluating a operator is a
+        // single lookup and a call
 
-        const auto lt = left->GetType();
-        const auto rt = right->GetType();
+        constexpr bool
+        IsNumberType(ValueType type)
+        {
+            return type == ValueType::Int || type == ValueType::Number;
+        }
+
+        constexpr BinaryOperation NullOperation = {NullKernel, StaticType::Unknown};
+        constexpr BinaryOperation InvalidOperation = {InvalidKernel, StaticType::Unknown};
 
-        if(lt == rt)
+        template<typename Operation, bool HasInt, bool HasNumber>
+        constexpr BinaryOperation
+        SelectArithmeticKernel(ValueType lhs, ValueType rhs)
         {
-            if(lt == ObjectType::Bool)
+            if(lhs == ValueType::Null || rhs == ValueType::Null) { return NullOperation; }
+            if constexpr(HasInt)
             {
-                return Object::FromBool
-                (
-                    invert_result
-                    ||
-                    (
-                        static_cast<BoolObject*>(left.get())->b
-                        ==
-                        static_cast<BoolObject*>(right.get())->b
-                    )
-                );
+                if(lhs == ValueType::Int && rhs == ValueType::Int) { return {IntKernel<Operation>, StaticType::Int}; }
             }
-            else if(lt == ObjectType::Int)
+            if constexpr(HasNumber)
             {
-                return Object::FromBool
-                (
-                    invert_result
-                    ||
-                    (
-                        static_cast<IntObject*>(left.get())->i
-                        ==
-                        static_cast<IntObject*>(right.get())->i
-                    )
-                );
+                if(IsNumberType(lhs) && IsNumberType(rhs)) { return {NumberKernel<Operation>, StaticType::Number}; }
             }
+            return InvalidOperation;
+        }
+
+        constexpr BinaryOperation
+        SelectModuloKernel(ValueType lhs, ValueType rhs)
+        {
+            // only defined for ints, the kernel reports the operands it fails on
+            if(lhs == ValueType::Null || rhs == ValueType::Null) { return NullOperation; }
+            if(lhs == ValueType::Int && rhs == ValueType::Int) { return {ModuloKernel, StaticType::Int}; }
+            return InvalidOperation;
         }
 
-        // todo(Gustav): allow comparing of strings?
+        template<typename Operation>
+        constexpr BinaryOperation
+        SelectCompareKernel(ValueType lhs, ValueType rhs)
+        {
+            if(lhs == ValueType::Null || rhs == ValueType::Null) { return NullOperation; }
+            // todo(Gustav): allow comparing of strings?
+            if(IsNumberType(lhs) && IsNumberType(rhs)) { return {CompareKernel<Operation>, StaticType::Bool}; }
+            return InvalidOperation;
+        }
 
-        log->AddError(op.where, log::Type::InvalidBinaryOperation, {op.lexeme});
-        log->AddError(lhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(left), Stringify(left)});
-        log->AddError(rhs->GetLocation(), log::Type::ThisEvaluatesTo, {TypeToString(right), Stringify(right)});
-        return nullptr;
-    }
+        template<bool Invert>
+        constexpr BinaryOperation
+        SelectEqualKernel(ValueType lhs, ValueType rhs)
+        {
+            if(lhs == ValueType::Null && rhs == ValueType::Null) { return {ConstantKernel<!Invert>, StaticType::Bool}; }
+            if(lhs == ValueType::Null || rhs == ValueType::Null) { return {ConstantKernel<Invert>, StaticType::Bool}; }
+            if(lhs != rhs) { return InvalidOperation; }
+            switch(lhs)
+            {
+            case ValueType::Bool: return {EqualBoolKernel<Invert>, StaticType::Bool};
+            case ValueType::Int: return {EqualIntKernel<Invert>, StaticType::Bool};
+            case ValueType::String: return {EqualStringKernel<Invert>, StaticType::Bool};
+            default: return InvalidOperation;
+            }
+        }
 
+        constexpr BinaryOperation
+        SelectKernel(BinaryOperator op, ValueType lhs, ValueType rhs)
+        {
+            switch(op)
+            {
+            case BinaryOperator::Add:
+                if(lhs == ValueType::String && rhs == ValueType::String) { return {ConcatKernel, StaticType::String}; }
+                return SelectArithmeticKernel<std::plus<>, true, true>(lhs, rhs);
+            case BinaryOperator::Subtract: return SelectArithmeticKernel<std::minus<>, true, true>(lhs, rhs);
+            case BinaryOperator::Multiply: return SelectArithmeticKernel<std::multiplies<>, true, true>(lhs, rhs);
+            case BinaryOperator::Divide: return SelectArithmeticKernel<std::divides<>, false, true>(lhs, rhs);
+            case BinaryOperator::Modulo: return SelectModuloKernel(lhs, rhs);
+            case BinaryOperator::Less: return SelectCompareKernel<std::less<>>(lhs, rhs);
+            case BinaryOperator::LessEqual: return SelectCompareKernel<std::less_equal<>>(lhs, rhs);
+            case BinaryOperator::Greater: return SelectCompareKernel<std::greater<>>(lhs, rhs);
+            case BinaryOperator::GreaterEqual: return SelectCompareKernel<std::greater_equal<>>(lhs, rhs);
+            case BinaryOperator::Equal: return SelectEqualKernel<false>(lhs, rhs);
+            case BinaryOperator::NotEqual: return SelectEqualKernel<true>(lhs, rhs);
+            default: return {UnhandledKernel, StaticType::Unknown};
+            }
+        }
 
-    std::shared_ptr<Object>
-    Interpreter::Visit(BinaryExpression* exp)
-    {
-        auto left = Evaluate(exp->left);
-        auto right = Evaluate(exp->right);
+        constexpr std::size_t
+        GetKernelIndex(BinaryOperator op, ValueType lhs, ValueType rhs)
+        {
+            return
+                (static_cast<std::size_t>(op) * ValueTypeCount + static_cast<std::size_t>(lhs)) * ValueTypeCount
+                + static_cast<std::size_t>(rhs);
+        }
 
-        switch(exp->op.type)
+        constexpr auto Kernels = []()
         {
-            case TokenType::Minus: return BinaryHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](int lhs, int rhs) -> int {return lhs - rhs;},
-                [](float lhs, float rhs) -> float { return lhs - rhs;}
-            );
-            case TokenType::Mult: return BinaryHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](int lhs, int rhs) -> int {return lhs * rhs;},
-                [](float lhs, float rhs) -> float { return lhs * rhs;}
-            );
-            case TokenType::Div: return BinaryHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                nullptr,
-                [](float lhs, float rhs) -> float { return lhs - rhs;}
-            );
-            case TokenType::Mod: return BinaryHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](int lhs, int rhs) -> int {return lhs % rhs;},
-                nullptr
-            );
-            case TokenType::Plus: return BinaryHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](int lhs, int rhs) -> int {return lhs + rhs;},
-                [](float lhs, float rhs) -> float { return lhs + rhs;},
-                [](std::shared_ptr<Object> lhs, std::shared_ptr<Object> rhs) -> std::optional<std::shared_ptr<Object>>
-                {
-                    if(lhs->GetType() == ObjectType::String && rhs->GetType() == ObjectType::String)
-                    {
-                        return Object::FromString
-                        (
-                            static_cast<StringObject*>(lhs.get())->s
-                            +
-                            static_cast<StringObject*>(rhs.get())->s
-                        );
-                    }
+            std::array<BinaryOperation, BinaryOperatorCount * ValueTypeCount * ValueTypeCount> kernels = {};
+            for(std::size_t op = 0; op < BinaryOperatorCount; op += 1)
+            for(std::size_t lhs = 0; lhs < ValueTypeCount; lhs += 1)
+            for(std::size_t rhs = 0; rhs < ValueTypeCount; rhs += 1)
+            {
+                const auto o = static_cast<BinaryOperator>(op);
+                const auto l = static_cast<ValueType>(lhs);
+                const auto r = static_cast<ValueType>(rhs);
+                kernels[GetKernelIndex(o, l, r)] = SelectKernel(o, l, r);
+            }
+            return kernels;
+        }();
 
-                    return std::nullopt;
-                }
-            );
-            case TokenType::Less: return CompareHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](float lhs, float rhs) -> bool { return lhs < rhs; }
-            );
-            case TokenType::LessEqual: return CompareHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](float lhs, float rhs) -> bool { return lhs <= rhs; }
-            );
-            case TokenType::Greater: return CompareHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](float lhs, float rhs) -> bool { return lhs > rhs; }
-            );
-            case TokenType::GreaterEqual: return CompareHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                [](float lhs, float rhs) -> bool { return lhs >= rhs; }
-            );
-            case TokenType::Equal: return EqualHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                false
-            );
-            case TokenType::NotEqual: return EqualHelper
-            (
-                log, exp->op,
-                exp->left, exp->right,
-                left, right,
-                true
-            );
 
-            default:
-                log->AddError
-                (
-                    FEL_WHERE_HERE,
-                    log::Type::InternalError,
-                    {"unhandled case in binary switch"}
-                );
-                return nullptr;
+        constexpr BinaryOperator
+        ToBinaryOperator(TokenType type)
+        {
+            switch(type)
+            {
+            case TokenType::Plus: return BinaryOperator::Add;
+            case TokenType::Minus: return BinaryOperator::Subtract;
+            case TokenType::Mult: return BinaryOperator::Multiply;
+            case TokenType::Div: return BinaryOperator::Divide;
+            case TokenType::Mod: return BinaryOperator::Modulo;
+            case TokenType::Less: return BinaryOperator::Less;
+            case TokenType::LessEqual: return BinaryOperator::LessEqual;
+            case TokenType::Greater: return BinaryOperator::Greater;
+            case TokenType::GreaterEqual: return BinaryOperator::GreaterEqual;
+            case TokenType::Equal: return BinaryOperator::Equal;
+            case TokenType::NotEqual: return BinaryOperator::NotEqual;
+            default: return BinaryOperator::Unhandled;
+            }
         }
+
+        // the token type is a byte so the operator is found without a switch
+        constexpr auto BinaryOperators = []()
+        {
+            std::array<BinaryOperator, 256> operators = {};
+            for(std::size_t type = 0; type < operators.size(); type += 1)
+            {
+                operators[type] = ToBinaryOperator(static_cast<TokenType>(type));
+            }
+            return operators;
+        }();
+
+        static_assert(sizeof(TokenType) == 1, "the operator lookup expects a byte sized token type");
+        static_assert(static_cast<int>(StaticType::String) == static_cast<int>(ValueType::String), "the known static types should match the value types");
+        static_assert
+        (
+            Kernels[GetKernelIndex(BinaryOperator::Modulo, ValueType::Number, ValueType::Int)].kernel == InvalidKernel,
+            "modulo is only defined for ints"
+        );
     }
 
 
-    std::shared_ptr<Object>
-    Interpreter::Visit(GroupingExpression* exp)
+    Value
+    EvaluateBinaryOperation(Log* log, Arena* arena, const Ast& ast, NodeIndex index, const Value& left, const Value& right)
     {
-        return Evaluate(exp->expression);
+        const auto op = BinaryOperators[static_cast<std::size_t>(ast.GetNode(index).op)];
+        const auto kernel = Kernels[GetKernelIndex(op, left.GetType(), right.GetType())].kernel;
+        return kernel(OperationContext{log, arena, ast, index}, left, right);
     }
 
 
-    std::shared_ptr<Object>
-    Interpreter::Visit(LiteralExpression* exp)
+    StaticType
+    GetBinaryOperationType(TokenType op, StaticType lhs, StaticType rhs)
     {
-        return exp->value;
+        if(lhs == StaticType::Unknown || rhs == StaticType::Unknown) { return StaticType::Unknown; }
+        const auto binary = BinaryOperators[static_cast<std::size_t>(op)];
+        return Kernels[GetKernelIndex(binary, static_cast<ValueType>(lhs), static_cast<ValueType>(rhs))].type;
     }
 
 
-    std::shared_ptr<Object>
-    Interpreter::Visit(UnaryExpression* exp)
+    StaticType
+    GetUnaryOperationType(TokenType op, StaticType rhs)
     {
-        auto right = Evaluate(exp->right);
+        switch(op)
+        {
+        case TokenType::Minus:
+            if(rhs == StaticType::Int || rhs == StaticType::Number || rhs == StaticType::Unknown) { return rhs; }
+            return StaticType::Unknown;
+        case TokenType::Not:
+            return StaticType::Bool;
+        default:
+            return StaticType::Unknown;
+        }
+    }
 
-        switch(exp->op.type)
+
+    Value
+    EvaluateUnaryOperation(Log* log, const Ast& ast, NodeIndex index, const Value& right)
+    {
+        const auto& node = ast.GetNode(index);
+
+        switch(node.op)
         {
             case TokenType::Minus:
-                switch(right->GetType())
+                switch(right.GetType())
                 {
-                    case ObjectType::Int: return Object::FromInt
-                    (
-                        static_cast<IntObject*>(right.get())->i * -1
-                    );
-                    case ObjectType::Number: return Object::FromFloat
-                    (
-                        static_cast<FloatObject*>(right.get())->f * -1
-                    );
+                    case ValueType::Int: return Value::FromInt(NegateInt(right.AsInt()));
+                    case ValueType::Number: return Value::FromFloat(right.AsNumber() * -1);
 
                     default:
                         log->AddError
@@ -391,11 +401,11 @@ namespace fel
                             log::Type::InternalError,
                             {"taking the negative of neither a number nor a int"}
                         );
-                        return nullptr;
+                        return {};
                 }
 
             case TokenType::Not:
-                return Object::FromBool(!IsTruthy(right));
+                return Value::FromBool(!IsTruthy(right));
 
             default:
                 log->AddError
@@ -404,15 +414,347 @@ namespace fel
                     log::Type::InternalError,
                     {"unhandled case in unary switch"}
                 );
-                return nullptr;
+                return {};
+        }
+    }
+
+
+    namespace
+    {
+        // a node that keeps seeing other types than it was specialized for
+        // stays generic instead of flapping between forms
+        constexpr std::uint8_t MaxDeoptimizations = 4;
+
+
+        Quickening
+        SelectQuickening(TokenType op, ValueType lhs, ValueType rhs)
+        {
+            if(lhs == ValueType::Int && rhs == ValueType::Int)
+            {
+                switch(op)
+                {
+                case TokenType::Plus: return Quickening::IntAdd;
+                case TokenType::Minus: return Quickening::IntSubtract;
+                case TokenType::Mult: return Quickening::IntMultiply;
+                case TokenType::Mod: return Quickening::IntModulo;
+                case TokenType::Less: return Quickening::IntLess;
+                case TokenType::LessEqual: return Quickening::IntLessEqual;
+                case TokenType::Greater: return Quickening::IntGreater;
+                case TokenType::GreaterEqual: return Quickening::IntGreaterEqual;
+                case TokenType::Equal: return Quickening::IntEqual;
+                case TokenType::NotEqual: return Quickening::IntNotEqual;
+                default: return Quickening::Generic;
+                }
+            }
+
+            if(lhs == ValueType::Number && rhs == ValueType::Number)
+            {
+                switch(op)
+                {
+                case TokenType::Plus: return Quickening::NumberAdd;
+                case TokenType::Minus: return Quickening::NumberSubtract;
+                case TokenType::Mult: return Quickening::NumberMultiply;
+                case TokenType::Div: return Quickening::NumberDivide;
+                case TokenType::Less: return Quickening::NumberLess;
+                case TokenType::LessEqual: return Quickening::NumberLessEqual;
+                case TokenType::Greater: return Quickening::NumberGreater;
+                case TokenType::GreaterEqual: return Quickening::NumberGreaterEqual;
+                default: return Quickening::Generic;
+                }
+            }
+
+            return Quickening::Generic;
+        }
+
+
+        bool
+        IsInts(const Value& lhs, const Value& rhs)
+        {
+            return lhs.GetType() == ValueType::Int && rhs.GetType() == ValueType::Int;
+        }
+
+
+        // a modulo that fails leaves the quickened form and is reported by
+        // the generic one
+        bool
+        IsDefinedModuloOfInts(const Value& lhs, const Value& rhs)
+        {
+            return IsInts(lhs, rhs) && IsDefinedModulo(lhs.AsInt(), rhs.AsInt());
+        }
+
+
+        bool
+        IsNumbers(const Value& lhs, const Value& rhs)
+        {
+            return lhs.GetType() == ValueType::Number && rhs.GetType() == ValueType::Number;
+        }
+
+
+        // run the specialized form, false if the operands aren't the types
+        // it was specialized for. Ints are compared as numbers like the
+        // generic form does
+        bool
+        RunQuickened(Quickening quickening, const Value& lhs, const Value& rhs, Value* result)
+        {
+            #define FEL_QUICK(name, guard, make, get, op) \
+            case Quickening::name: \
+                if(!guard(lhs, rhs)) { return false; } \
+                *result = Value::make(get(lhs) op get(rhs)); \
+                return true;
+            // ints wrap instead of overflowing like the int kernels
+            #define FEL_QUICK_INT(name, operation) \
+            case Quickening::name: \
+                if(!IsInts(lhs, rhs)) { return false; } \
+                *result = Value::FromInt(WrapInt(operation{}, lhs.AsInt(), rhs.AsInt())); \
+                return true;
+            #define FEL_AS_INT(value) value.AsInt()
+            #define FEL_AS_NUMBER(value) value.AsNumber()
+            #define FEL_INT_AS_NUMBER(value) static_cast<float>(value.AsInt())
+
+            switch(quickening)
+            {
+            FEL_QUICK_INT(IntAdd, std::plus<>)
+            FEL_QUICK_INT(IntSubtract, std::minus<>)
+            FEL_QUICK_INT(IntMultiply, std::multiplies<>)
+            FEL_QUICK(IntModulo, IsDefinedModuloOfInts, FromInt, FEL_AS_INT, %)
+            FEL_QUICK(IntLess, IsInts, FromBool, FEL_INT_AS_NUMBER, <)
+            FEL_QUICK(IntLessEqual, IsInts, FromBool, FEL_INT_AS_NUMBER, <=)
+            FEL_QUICK(IntGreater, IsInts, FromBool, FEL_INT_AS_NUMBER, >)
+            FEL_QUICK(IntGreaterEqual, IsInts, FromBool, FEL_INT_AS_NUMBER, >=)
+            FEL_QUICK(IntEqual, IsInts, FromBool, FEL_AS_INT, ==)
+            FEL_QUICK(IntNotEqual, IsInts, FromBool, FEL_AS_INT, !=)
+            FEL_QUICK(NumberAdd, IsNumbers, FromFloat, FEL_AS_NUMBER, +)
+            FEL_QUICK(NumberSubtract, IsNumbers, FromFloat, FEL_AS_NUMBER, -)
+            FEL_QUICK(NumberMultiply, IsNumbers, FromFloat, FEL_AS_NUMBER, *)
+            FEL_QUICK(NumberDivide, IsNumbers, FromFloat, FEL_AS_NUMBER, /)
+            FEL_QUICK(NumberLess, IsNumbers, FromBool, FEL_AS_NUMBER, <)
+            FEL_QUICK(NumberLessEqual, IsNumbers, FromBool, FEL_AS_NUMBER, <=)
+            FEL_QUICK(NumberGreater, IsNumbers, FromBool, FEL_AS_NUMBER, >)
+            FEL_QUICK(NumberGreaterEqual, IsNumbers, FromBool, FEL_AS_NUMBER, >=)
+            default: return false;
+            }
+
+            #undef FEL_QUICK
+            #undef FEL_QUICK_INT
+            #undef FEL_AS_INT
+            #undef FEL_AS_NUMBER
+            #undef FEL_INT_AS_NUMBER
+        }
+    }
+
+
+    Value
+    Interpreter::EvaluateBinary(const Ast& ast, NodeIndex index)
+    {
+        const auto& node = ast.GetNode(index);
+        const auto left = Evaluate(ast, node.left);
+        const auto right = Evaluate(ast, node.right);
+
+        // the node is specialized for the types it sees the first time and
+        // goes back to unseen if the guard fails
+        if(node.quickening == Quickening::Unseen)
+        {
+            node.quickening = SelectQuickening(node.op, left.GetType(), right.GetType());
+        }
+
+        if(node.quickening != Quickening::Generic)
+        {
+            Value result;
+            if(RunQuickened(node.quickening, left, right, &result))
+            {
+                return result;
+            }
+
+            node.deoptimizations += 1;
+            node.quickening = node.deoptimizations < MaxDeoptimizations ? Quickening::Unseen : Quickening::Generic;
+        }
+
+        return EvaluateBinaryOperation(log, &arena, ast, index, left, right);
+    }
+
+
+    Value
+    Interpreter::EvaluateUnary(const Ast& ast, NodeIndex index)
+    {
+        const auto right = Evaluate(ast, ast.GetNode(index).right);
+        return EvaluateUnaryOperation(log, ast, index, right);
+    }
+
+
+    int
+    Interpreter::EvaluateInt(const Ast& ast, NodeIndex index)
+    {
+        // a int is either a int literal or a operation on ints
+        const auto& node = ast.GetNode(index);
+        switch(node.type)
+        {
+        case NodeType::Variable: break;
+        case NodeType::Literal: return ast.GetLiteral(index).AsInt();
+        case NodeType::Grouping: return EvaluateInt(ast, node.right);
+        case NodeType::Unary: return NegateInt(EvaluateInt(ast, node.right));
+        case NodeType::Binary:
+            {
+                const auto lhs = EvaluateInt(ast, node.left);
+                const auto rhs = EvaluateInt(ast, node.right);
+                switch(node.op)
+                {
+                case TokenType::Plus: return WrapInt(std::plus<>{}, lhs, rhs);
+                case TokenType::Minus: return WrapInt(std::minus<>{}, lhs, rhs);
+                case TokenType::Mult: return WrapInt(std::multiplies<>{}, lhs, rhs);
+                // modulo can fail so it's never run here, see Ast::can_fail
+                default: break;
+                }
+            }
+            break;
+        }
+
+        assert(false && "not a int expression");
+        return 0;
+    }
+
+
+    float
+    Interpreter::EvaluateNumber(const Ast& ast, NodeIndex index)
+    {
+        const auto& node = ast.GetNode(index);
+        switch(node.type)
+        {
+        case NodeType::Variable: break;
+        case NodeType::Literal: return ast.GetLiteral(index).AsNumber();
+        case NodeType::Grouping: return EvaluateNumber(ast, node.right);
+        case NodeType::Unary: return EvaluateNumber(ast, node.right) * -1;
+        case NodeType::Binary:
+            {
+                const auto lhs = EvaluateAsNumber(ast, node.left);
+                const auto rhs = EvaluateAsNumber(ast, node.right);
+                switch(node.op)
+                {
+                case TokenType::Plus: return lhs + rhs;
+                case TokenType::Minus: return lhs - rhs;
+                case TokenType::Mult: return lhs * rhs;
+                case TokenType::Div: return lhs / rhs;
+                default: break;
+                }
+            }
+            break;
+        }
+
+        assert(false && "not a number expression");
+        return 0.0f;
+    }
+
+
+    bool
+    Interpreter::EvaluateBool(const Ast& ast, NodeIndex index)
+    {
+        const auto& node = ast.GetNode(index);
+        switch(node.type)
+        {
+        case NodeType::Variable: break;
+        case NodeType::Literal: return ast.GetLiteral(index).AsBool();
+        case NodeType::Grouping: return EvaluateBool(ast, node.right);
+        case NodeType::Unary:
+            switch(ast.types[node.right])
+            {
+            case StaticType::Null: return true;
+            case StaticType::Bool: return !EvaluateBool(ast, node.right);
+            case StaticType::Unknown: return !IsTruthy(Evaluate(ast, node.right));
+            // the rest are always true, a operand that can fail isn't run here
+            default: return false;
+            }
+        case NodeType::Binary:
+            switch(node.op)
+            {
+            case TokenType::Less: return EvaluateAsNumber(ast, node.left) < EvaluateAsNumber(ast, node.right);
+            case TokenType::LessEqual: return EvaluateAsNumber(ast, node.left) <= EvaluateAsNumber(ast, node.right);
+            case TokenType::Greater: return EvaluateAsNumber(ast, node.left) > EvaluateAsNumber(ast, node.right);
+            case TokenType::GreaterEqual: return EvaluateAsNumber(ast, node.left) >= EvaluateAsNumber(ast, node.right);
+            case TokenType::Equal: return EvaluateIsEqual(ast, node.left, node.right);
+            case TokenType::NotEqual: return !EvaluateIsEqual(ast, node.left, node.right);
+            default: break;
+            }
+            break;
+        }
+
+        assert(false && "not a bool expression");
+        return false;
+    }
+
+
+    float
+    Interpreter::EvaluateAsNumber(const Ast& ast, NodeIndex index)
+    {
+        if(ast.types[index] == StaticType::Int)
+        {
+            return static_cast<float>(EvaluateInt(ast, index));
+        }
+        return EvaluateNumber(ast, index);
+    }
+
+
+    bool
+    Interpreter::EvaluateIsEqual(const Ast& ast, NodeIndex lhs, NodeIndex rhs)
+    {
+        // the types are known and the same or one of them is null, the
+        // operands can't fail so a null doesn't need the other side
+        const auto lt = ast.types[lhs];
+        const auto rt = ast.types[rhs];
+        if(lt == StaticType::Null || rt == StaticType::Null) { return lt == rt; }
+        switch(lt)
+        {
+        case StaticType::Bool: return EvaluateBool(ast, lhs) == EvaluateBool(ast, rhs);
+        case StaticType::Int: return EvaluateInt(ast, lhs) == EvaluateInt(ast, rhs);
+        case StaticType::String: return IsSameString(Evaluate(ast, lhs), Evaluate(ast, rhs));
+        default:
+            assert(false && "not a equal expression");
+            return false;
+        }
+    }
+
+
+    Value
+    Interpreter::Evaluate(const Ast& ast, NodeIndex index)
+    {
+        if(ast.types.empty() == false && ast.can_fail[index] == false)
+        {
+            assert(ast.types.size() == ast.nodes.size());
+            switch(ast.types[index])
+            {
+            case StaticType::Int: return Value::FromInt(EvaluateInt(ast, index));
+            case StaticType::Number: return Value::FromFloat(EvaluateNumber(ast, index));
+            case StaticType::Bool: return Value::FromBool(EvaluateBool(ast, index));
+            default: break;
+            }
+        }
+
+        const auto& node = ast.GetNode(index);
+        switch(node.type)
+        {
+        case NodeType::Binary: return EvaluateBinary(ast, index);
+        case NodeType::Grouping: return Evaluate(ast, node.right);
+        case NodeType::Literal: return ast.GetLiteral(index);
+        case NodeType::Unary: return EvaluateUnary(ast, index);
+        case NodeType::Variable:
+            // variables are only bound when evaluating a batch, see fel/batch.h
+            log->AddError(ast.GetWhere(index), log::Type::UnknownVariable, {std::string{ast.GetVariable(index)->s}});
+            return {};
+        default:
+            log->AddError
+            (
+                FEL_WHERE_HERE,
+                log::Type::InternalError,
+                {"unhandled case in node switch"}
+            );
+            return {};
         }
     }
 
 
-    std::shared_ptr<Object>
-    Interpreter::Evaluate(std::shared_ptr<Expression> expression)
+    Value
+    Interpreter::Evaluate(const Ast& ast)
     {
-        auto interpreter = Interpreter{log};
-        return expression->Visit(&interpreter);
+        arena.Reset();
+        const auto result = Evaluate(ast, ast.root);
+        return Value::CopyOutOfArena(result);
     }
 }
@@ -1,33 +1,112 @@
 #ifndef FEL_INTERPRETER_H
 #define FEL_INTERPRETER_H
 
+#include <limits>
+
+#include "fel/arena.h"
 #include "fel/ast.h"
 
 namespace fel
 {
     struct Log;
 
-    struct Interpreter : public ExpressionVisitorObject
+
+    // apply the operator of a node to the already evaluated operands, shared
+    // by everything that runs code so the errors are reported the same way
+    Value
+    EvaluateBinaryOperation(Log* log, Arena* arena, const Ast& ast, NodeIndex index, const Value& left, const Value& right);
+
+    Value
+    EvaluateUnaryOperation(Log* log, const Ast& ast, NodeIndex index, const Value& right);
+
+
+    // the type a operator gives when run with operands of the types, Unknown
+    // if either is Unknown or if running it is a error
+    StaticType
+    GetBinaryOperationType(TokenType op, StaticType lhs, StaticType rhs);
+
+    StaticType
+    GetUnaryOperationType(TokenType op, StaticType rhs);
+
+
+    // lhs % rhs is undefined if rhs is 0 or if the result overflows, it's a
+    // error when running instead of a trap or undefined behaviour
+    bool
+    IsDefinedModulo(int lhs, int rhs);
+
+    // ints wrap around instead of overflowing, signed overflow is undefined
+    // so the operation is done on unsigned ints
+    template<typename Operation>
+    int
+    WrapInt(Operation operation, int lhs, int rhs);
+
+    int
+    NegateInt(int value);
+
+
+    struct Interpreter
     {
         explicit Interpreter(Log* l);
 
-        std::shared_ptr<Object>
-        Visit(BinaryExpression* exp);
+        // the values made while evaluating are allocated in the arena and
+        // released when the next evaluation starts, only the result is
+        // copied out of it
+        Value
+        Evaluate(const Ast& ast);
+
+        Value
+        Evaluate(const Ast& ast, NodeIndex index);
 
-        std::shared_ptr<Object>
-        Visit(GroupingExpression* exp);
+        Value
+        EvaluateBinary(const Ast& ast, NodeIndex index);
 
-        std::shared_ptr<Object>
-        Visit(LiteralExpression* exp);
+        Value
+        EvaluateUnary(const Ast& ast, NodeIndex index);
 
-        std::shared_ptr<Object>
-        Visit(UnaryExpression* exp);
+        // if the ast has types the expressions that are known to be ints,
+        // numbers or bools are run without making values. The parts that
+        // can fail are run as usual so the errors and results are the same
+        int
+        EvaluateInt(const Ast& ast, NodeIndex index);
 
-        std::shared_ptr<Object>
-        Evaluate(std::shared_ptr<Expression> expression);
+        float
+        EvaluateNumber(const Ast& ast, NodeIndex index);
+
+        bool
+        EvaluateBool(const Ast& ast, NodeIndex index);
+
+        // a int or a number as a number
+        float
+        EvaluateAsNumber(const Ast& ast, NodeIndex index);
+
+        bool
+        EvaluateIsEqual(const Ast& ast, NodeIndex lhs, NodeIndex rhs);
 
         Log* log;
+        Arena arena;
     };
+
+
+    inline bool
+    IsDefinedModulo(int lhs, int rhs)
+    {
+        return rhs != 0 && !(lhs == std::numeric_limits<int>::min() && rhs == -1);
+    }
+
+
+    template<typename Operation>
+    int
+    WrapInt(Operation operation, int lhs, int rhs)
+    {
+        return static_cast<int>(operation(static_cast<unsigned int>(lhs), static_cast<unsigned int>(rhs)));
+    }
+
+
+    inline int
+    NegateInt(int value)
+    {
+        return static_cast<int>(0u - static_cast<unsigned int>(value));
+    }
 }
 
 #endif  // FEL_INTERPRETER_H
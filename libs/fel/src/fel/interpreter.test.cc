@@ -0,0 +1,266 @@
+#include "catch.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+#include "fel/typeinference.h"
+
+using namespace fel;
+
+
+namespace
+{
+    Value
+    Run(const std::string& source)
+    {
+        Log log;
+        const auto file = File{"source", source};
+        auto parser = Parser{file, &log};
+        const auto ast = parser.Parse();
+        REQUIRE(ast);
+
+        auto interpreter = Interpreter{&log};
+        const auto result = interpreter.Evaluate(*ast);
+        CHECK(log.IsEmpty());
+        return result;
+    }
+}
+
+
+TEST_CASE("interpreter-values", "[interpreter]")
+{
+    SECTION("int arithmetic stays int")
+    {
+        const auto sum = Run("1 + 2 * 3");
+        REQUIRE(sum.GetType() == ValueType::Int);
+        CHECK(sum.AsInt() == 7);
+
+        const auto difference = Run("-4 - -2");
+        REQUIRE(difference.GetType() == ValueType::Int);
+        CHECK(difference.AsInt() == -2);
+    }
+
+    SECTION("division is always a number")
+    {
+        const auto half = Run("7 / 2");
+        REQUIRE(half.GetType() == ValueType::Number);
+        CHECK(half.AsNumber() == 3.5f);
+
+        const auto whole = Run("6 / 2");
+        REQUIRE(whole.GetType() == ValueType::Number);
+        CHECK(whole.AsNumber() == 3.0f);
+    }
+
+    SECTION("mixing int and number gives a number")
+    {
+        const auto sum = Run("1.5 + 1");
+        REQUIRE(sum.GetType() == ValueType::Number);
+        CHECK(sum.AsNumber() == 2.5f);
+
+        const auto product = Run("2 * 1.5 + 1");
+        REQUIRE(product.GetType() == ValueType::Number);
+        CHECK(product.AsNumber() == 4.0f);
+    }
+
+    SECTION("comparisons")
+    {
+        const std::vector<std::pair<std::string, bool>> cases =
+        {
+            {"3 != 4", true}, {"3 != 3", false}, {"1.5 < 2.5", true},
+            {"1 < 2", true}, {"2.5 >= 2", true}, {"2 > 2", false},
+            {"'a' == 'a'", true}, {"null == null", true}, {"null != 1", true},
+            {"!0", false}, {"!null", true}, {"!!true", true}
+        };
+        for(const auto& [source, expected]: cases)
+        {
+            INFO(source);
+            const auto result = Run(source);
+            REQUIRE(result.GetType() == ValueType::Bool);
+            CHECK(result.AsBool() == expected);
+        }
+    }
+
+    SECTION("strings")
+    {
+        const auto result = Run("'a' + 'b'");
+        REQUIRE(result.GetType() == ValueType::String);
+        CHECK(result.AsString() == "ab");
+    }
+}
+
+
+TEST_CASE("interpreter-quickening", "[interpreter]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"1 + 2"}};
+    auto parser = Parser{file, &log};
+    auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    auto interpreter = Interpreter{&log};
+    const auto& root = ast->GetNode(ast->root);
+    CHECK(root.quickening == Quickening::Unseen);
+
+    CHECK(Stringify(interpreter.Evaluate(*ast)) == "3");
+    CHECK(root.quickening == Quickening::IntAdd);
+
+    // the operands change type, the guard fails and the generic form is used
+    // until the node stops being specialized
+    const auto& left = ast->GetNode(root.left);
+    for(int i = 0; i < 10; i += 1)
+    {
+        const auto is_number = i % 2 == 0;
+        ast->literals[left.right] = is_number ? Value::FromFloat(1.5f) : Value::FromInt(1);
+        CHECK(Stringify(interpreter.Evaluate(*ast)) == (is_number ? "3.5" : "3"));
+    }
+    CHECK(root.quickening == Quickening::Generic);
+    CHECK(log.IsEmpty());
+}
+
+
+TEST_CASE("interpreter-int-overflow", "[interpreter]")
+{
+    // ints wrap around like they do on the jit and in batches
+    const std::vector<std::pair<std::string, int>> sources =
+    {
+        {"2147483647 + 1", -2147483647 - 1},
+        {"(0 - 2147483647) - 2", 2147483647},
+        {"65536 * 65536", 0},
+        {"-(0 - 2147483647 - 1)", -2147483647 - 1},
+    };
+
+    for(const auto& [source, expected]: sources)
+    {
+        INFO(source);
+        Log log;
+        const auto file = File{"source", source};
+        auto parser = Parser{file, &log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+
+        // the first run is generic and the second is quickened
+        auto interpreter = Interpreter{&log};
+        CHECK(interpreter.Evaluate(*ast).AsInt() == expected);
+        CHECK(interpreter.Evaluate(*ast).AsInt() == expected);
+
+        REQUIRE(InferTypes(&*ast, &log));
+        CHECK(interpreter.Evaluate(*ast).AsInt() == expected);
+        CHECK(log.IsEmpty());
+    }
+}
+
+
+namespace
+{
+    // there is no syntax for modulo yet so the root operator is replaced
+    Ast
+    ParseModulo(const File& file)
+    {
+        Log log;
+        auto parser = Parser{file, &log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+        REQUIRE(ast->GetNode(ast->root).type == NodeType::Binary);
+        ast->nodes[ast->root].op = TokenType::Mod;
+        return std::move(*ast);
+    }
+
+
+    bool
+    HasUndefinedModulo(const Log& log)
+    {
+        return log.entries.empty() == false && log.entries[0].type == log::Type::UndefinedModulo;
+    }
+}
+
+
+TEST_CASE("interpreter-modulo", "[interpreter]")
+{
+    const auto valid = File{"source", std::string{"7 + 3"}};
+    const auto by_zero = File{"source", std::string{"7 + 0"}};
+    const auto overflow = File{"source", std::string{"(0 - 2147483647 - 1) + -1"}};
+
+    SECTION("generic")
+    {
+        Log log;
+        auto interpreter = Interpreter{&log};
+        CHECK(Stringify(interpreter.Evaluate(ParseModulo(valid))) == "1");
+        CHECK(log.IsEmpty());
+
+        CHECK(interpreter.Evaluate(ParseModulo(by_zero)).IsNull());
+        CHECK(HasUndefinedModulo(log));
+
+        log.entries.clear();
+        CHECK(interpreter.Evaluate(ParseModulo(overflow)).IsNull());
+        CHECK(HasUndefinedModulo(log));
+    }
+
+    SECTION("quickened")
+    {
+        Log log;
+        auto interpreter = Interpreter{&log};
+        auto ast = ParseModulo(valid);
+        CHECK(Stringify(interpreter.Evaluate(ast)) == "1");
+        CHECK(ast.GetNode(ast.root).quickening == Quickening::IntModulo);
+
+        // the guard fails and the generic form reports it
+        const auto& root = ast.GetNode(ast.root);
+        ast.literals[ast.GetNode(root.right).right] = Value::FromInt(0);
+        CHECK(interpreter.Evaluate(ast).IsNull());
+        CHECK(HasUndefinedModulo(log));
+    }
+
+    SECTION("typed")
+    {
+        Log log;
+        auto ast = ParseModulo(by_zero);
+        REQUIRE(InferTypes(&ast, &log));
+        CHECK(ast.types[ast.root] == StaticType::Int);
+
+        auto interpreter = Interpreter{&log};
+        CHECK(interpreter.Evaluate(ast).IsNull());
+        CHECK(HasUndefinedModulo(log));
+    }
+}
+
+
+TEST_CASE("interpreter-typed-can-fail", "[interpreter]")
+{
+    // parts that can fail are run like without types, even where the typed
+    // form only needs the type of a operand. + is replaced with modulo
+    const std::vector<std::string> sources =
+    {
+        "!(7 + 0)", "null == (7 + 0)", "(7 + 0) != null", "(7 + 0) + 1", "(7 + 0) < 2",
+        "!!(7 + 3)", "null == (7 + 3)", "!x", "null == !x", "-x == null"
+    };
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+        Log parse_log;
+        auto parser = Parser{file, &parse_log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+        for(auto& node: ast->nodes)
+        {
+            if(node.type == NodeType::Binary && node.op == TokenType::Plus) { node.op = TokenType::Mod; }
+        }
+
+        Log untyped_log;
+        const auto expected = Interpreter{&untyped_log}.Evaluate(*ast);
+
+        Log typed_log;
+        InferTypes(&*ast, &typed_log);
+        typed_log.entries.clear();
+        const auto result = Interpreter{&typed_log}.Evaluate(*ast);
+
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(typed_log.entries == untyped_log.entries);
+    }
+}
@@ -0,0 +1,422 @@
+#include "fel/jit.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "fel/log.h"
+#include "fel/typeinference.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#define FEL_JIT_X64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define FEL_JIT_X64 0
+#endif
+
+namespace fel
+{
+#if FEL_JIT_X64
+    namespace
+    {
+        // a simple stack machine: ints and bools are in eax and numbers in
+        // xmm0, the left side of a binary operation is pushed to the stack
+        // while the right side is run. Nothing is called so the stack
+        // doesn't need to be aligned
+        struct Emitter
+        {
+            const Ast& ast;
+            std::vector<std::uint8_t> code;
+
+            void
+            Emit(std::initializer_list<std::uint8_t> bytes)
+            {
+                code.insert(code.end(), bytes);
+            }
+
+            void
+            Emit32(std::uint32_t value)
+            {
+                for(int shift = 0; shift < 32; shift += 8)
+                {
+                    code.emplace_back(static_cast<std::uint8_t>(value >> shift));
+                }
+            }
+
+            // mov eax, imm32
+            void
+            EmitLoad(std::uint32_t value)
+            {
+                Emit({0xB8});
+                Emit32(value);
+            }
+
+            void PushInt() { Emit({0x50}); } // push rax
+            void PopInt() { Emit({0x59}); } // pop rcx, the left side is in ecx
+
+            // sub rsp, 8 and movss [rsp], xmm0
+            void PushNumber() { Emit({0x48, 0x83, 0xEC, 0x08, 0xF3, 0x0F, 0x11, 0x04, 0x24}); }
+
+            // movss xmm1, [rsp] and add rsp, 8, the left side is in xmm1
+            void PopNumber() { Emit({0xF3, 0x0F, 0x10, 0x0C, 0x24, 0x48, 0x83, 0xC4, 0x08}); }
+
+            // setcc al and movzx eax, al
+            void
+            EmitSet(std::uint8_t condition)
+            {
+                Emit({0x0F, condition, 0xC0, 0x0F, 0xB6, 0xC0});
+            }
+
+            bool
+            Compile(NodeIndex index)
+            {
+                const auto& node = ast.GetNode(index);
+                switch(node.type)
+                {
+                case NodeType::Literal: return CompileLiteral(index);
+                case NodeType::Grouping: return Compile(node.right);
+                case NodeType::Unary: return CompileUnary(index);
+                case NodeType::Binary: return CompileBinary(index);
+                case NodeType::Variable: return false;
+                }
+                return false;
+            }
+
+            // a int is converted with cvtsi2ss xmm0, eax
+            bool
+            CompileNumber(NodeIndex index)
+            {
+                if(Compile(index) == false) { return false; }
+                if(ast.types[index] == StaticType::Int) { Emit({0xF3, 0x0F, 0x2A, 0xC0}); }
+                return true;
+            }
+
+            bool
+            CompileLiteral(NodeIndex index)
+            {
+                const auto& value = ast.GetLiteral(index);
+                switch(value.GetType())
+                {
+                case ValueType::Bool:
+                    EmitLoad(value.AsBool() ? 1 : 0);
+                    return true;
+                case ValueType::Int:
+                    EmitLoad(static_cast<std::uint32_t>(value.AsInt()));
+                    return true;
+                case ValueType::Number:
+                    {
+                        const auto number = value.AsNumber();
+                        std::uint32_t bits;
+                        std::memcpy(&bits, &number, sizeof(bits));
+                        EmitLoad(bits);
+                        Emit({0x66, 0x0F, 0x6E, 0xC0}); // movd xmm0, eax
+                    }
+                    return true;
+                default:
+                    return false;
+                }
+            }
+
+            bool
+            CompileUnary(NodeIndex index)
+            {
+                const auto& node = ast.GetNode(index);
+                const auto type = ast.types[index];
+                const auto right = ast.types[node.right];
+                if(type == StaticType::Unknown) { return false; }
+
+                switch(node.op)
+                {
+                case TokenType::Minus:
+                    if(Compile(node.right) == false) { return false; }
+                    if(type == StaticType::Int)
+                    {
+                        Emit({0xF7, 0xD8}); // neg eax
+                    }
+                    else
+                    {
+                        // flip the sign bit, the same as multiplying with -1
+                        Emit({0x66, 0x0F, 0x7E, 0xC0}); // movd eax, xmm0
+                        Emit({0x35}); Emit32(0x80000000u); // xor eax, imm32
+                        Emit({0x66, 0x0F, 0x6E, 0xC0}); // movd xmm0, eax
+                    }
+                    return true;
+                case TokenType::Not:
+                    // the constants below don't run the operand, native code
+                    // can't report its errors
+                    if(ast.can_fail[node.right]) { return false; }
+                    switch(right)
+                    {
+                    case StaticType::Bool:
+                        if(Compile(node.right) == false) { return false; }
+                        Emit({0x83, 0xF0, 0x01}); // xor eax, 1
+                        return true;
+                    case StaticType::Null: EmitLoad(1); return true;
+                    case StaticType::Unknown: return false;
+                    // the rest are always true and can't fail
+                    default: EmitLoad(0); return true;
+                    }
+                default:
+                    return false;
+                }
+            }
+
+            bool
+            CompileIntOperands(const Node& node)
+            {
+                if(Compile(node.left) == false) { return false; }
+                PushInt();
+                if(Compile(node.right) == false) { return false; }
+                PopInt();
+                return true;
+            }
+
+            bool
+            CompileNumberOperands(const Node& node)
+            {
+                if(CompileNumber(node.left) == false) { return false; }
+                PushNumber();
+                if(CompileNumber(node.right) == false) { return false; }
+                PopNumber();
+                return true;
+            }
+
+            bool
+            CompileBinary(NodeIndex index)
+            {
+                const auto& node = ast.GetNode(index);
+                const auto type = ast.types[index];
+                const auto lhs = ast.types[node.left];
+                const auto rhs = ast.types[node.right];
+
+                if(type == StaticType::Int)
+                {
+                    if(CompileIntOperands(node) == false) { return false; }
+                    switch(node.op)
+                    {
+                    case TokenType::Plus: Emit({0x01, 0xC1}); break; // add ecx, eax
+                    case TokenType::Minus: Emit({0x29, 0xC1}); break; // sub ecx, eax
+                    case TokenType::Mult: Emit({0x0F, 0xAF, 0xC8}); break; // imul ecx, eax
+                    // modulo isn't compiled, idiv traps on a divisor of 0 and
+                    // on overflow and native code can't report the error
+                    default: return false;
+                    }
+                    Emit({0x89, 0xC8}); // mov eax, ecx
+                    return true;
+                }
+
+                if(type == StaticType::Number)
+                {
+                    if(CompileNumberOperands(node) == false) { return false; }
+                    switch(node.op)
+                    {
+                    case TokenType::Plus: Emit({0xF3, 0x0F, 0x58, 0xC8}); break; // addss xmm1, xmm0
+                    case TokenType::Minus: Emit({0xF3, 0x0F, 0x5C, 0xC8}); break; // subss xmm1, xmm0
+                    case TokenType::Mult: Emit({0xF3, 0x0F, 0x59, 0xC8}); break; // mulss xmm1, xmm0
+                    case TokenType::Div: Emit({0xF3, 0x0F, 0x5E, 0xC8}); break; // divss xmm1, xmm0
+                    default: return false;
+                    }
+                    Emit({0x0F, 0x28, 0xC1}); // movaps xmm0, xmm1
+                    return true;
+                }
+
+                if(type != StaticType::Bool) { return false; }
+
+                // ints are compared as numbers like the interpreter does, the
+                // operands are swapped for less so a unordered compare is false
+                constexpr std::uint8_t Above = 0x97;
+                constexpr std::uint8_t AboveEqual = 0x93;
+                constexpr std::uint8_t Equal = 0x94;
+                constexpr std::uint8_t NotEqual = 0x95;
+                const auto compare = [this, &node](bool swap, std::uint8_t condition)
+                {
+                    if(CompileNumberOperands(node) == false) { return false; }
+                    // ucomiss xmm0, xmm1 or ucomiss xmm1, xmm0
+                    Emit({0x0F, 0x2E, static_cast<std::uint8_t>(swap ? 0xC1 : 0xC8)});
+                    EmitSet(condition);
+                    return true;
+                };
+
+                switch(node.op)
+                {
+                case TokenType::Less: return compare(true, Above);
+                case TokenType::LessEqual: return compare(true, AboveEqual);
+                case TokenType::Greater: return compare(false, Above);
+                case TokenType::GreaterEqual: return compare(false, AboveEqual);
+                case TokenType::Equal:
+                case TokenType::NotEqual:
+                    {
+                        const auto is_equal = node.op == TokenType::Equal;
+                        if(lhs == StaticType::Null || rhs == StaticType::Null)
+                        {
+                            if(ast.can_fail[node.left] || ast.can_fail[node.right]) { return false; }
+                            EmitLoad((lhs == rhs) == is_equal ? 1 : 0);
+                            return true;
+                        }
+                        if(lhs != StaticType::Int && lhs != StaticType::Bool) { return false; }
+                        if(CompileIntOperands(node) == false) { return false; }
+                        Emit({0x39, 0xC1}); // cmp ecx, eax
+                        EmitSet(is_equal ? Equal : NotEqual);
+                        return true;
+                    }
+                default:
+                    return false;
+                }
+            }
+        };
+    }
+#endif
+
+
+    bool
+    IsJitSupported()
+    {
+        return FEL_JIT_X64 != 0;
+    }
+
+
+    NativeCode::NativeCode(void* a_memory, std::size_t a_size, StaticType a_type)
+        : memory(a_memory)
+        , size(a_size)
+        , type(a_type)
+    {
+    }
+
+
+    NativeCode::~NativeCode()
+    {
+#if FEL_JIT_X64
+        if(memory != nullptr)
+        {
+            munmap(memory, size);
+        }
+#endif
+    }
+
+
+    NativeCode::NativeCode(NativeCode&& rhs) noexcept
+        : memory(std::exchange(rhs.memory, nullptr))
+        , size(std::exchange(rhs.size, 0))
+        , type(rhs.type)
+    {
+    }
+
+
+    NativeCode&
+    NativeCode::operator=(NativeCode&& rhs) noexcept
+    {
+        std::swap(memory, rhs.memory);
+        std::swap(size, rhs.size);
+        std::swap(type, rhs.type);
+        return *this;
+    }
+
+
+    Value
+    NativeCode::Run() const
+    {
+        assert(memory != nullptr);
+        switch(type)
+        {
+        case StaticType::Int: return Value::FromInt(reinterpret_cast<int (*)()>(memory)());
+        case StaticType::Bool: return Value::FromBool(reinterpret_cast<int (*)()>(memory)() != 0);
+        case StaticType::Number: return Value::FromFloat(reinterpret_cast<float (*)()>(memory)());
+        default:
+            assert(false && "invalid native type");
+            return {};
+        }
+    }
+
+
+    std::optional<NativeCode>
+    CompileNative(const Ast& ast)
+    {
+#if FEL_JIT_X64
+        if(ast.root == NoNode) { return std::nullopt; }
+
+        // the types are needed to know what registers to use, the errors
+        // are reported by the interpreter when it's run
+        std::optional<Ast> typed;
+        if(ast.types.empty())
+        {
+            typed = ast;
+            Log ignored;
+            InferTypes(&*typed, &ignored);
+        }
+        const auto& source = typed ? *typed : ast;
+
+        const auto type = source.types[source.root];
+        if(type != StaticType::Int && type != StaticType::Number && type != StaticType::Bool)
+        {
+            return std::nullopt;
+        }
+
+        auto emitter = Emitter{source, {}};
+        if(emitter.Compile(source.root) == false)
+        {
+            return std::nullopt;
+        }
+        emitter.Emit({0xC3}); // ret
+
+        // the pages are never writable and executable at the same time
+        const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const auto size = (emitter.code.size() + page - 1) / page * page;
+        auto* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(memory == MAP_FAILED)
+        {
+            return std::nullopt;
+        }
+        std::memcpy(memory, emitter.code.data(), emitter.code.size());
+        if(mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+        {
+            munmap(memory, size);
+            return std::nullopt;
+        }
+
+        return NativeCode{memory, size, type};
+#else
+        return std::nullopt;
+#endif
+    }
+
+
+    TieredExpression::TieredExpression(const Ast* a_ast, Log* log, JitMode a_mode, std::size_t a_threshold)
+        : ast(a_ast)
+        , mode(a_mode)
+        , threshold(a_threshold)
+        , interpreter(log)
+    {
+    }
+
+
+    Value
+    TieredExpression::Evaluate()
+    {
+        runs += 1;
+
+        const auto is_hot = mode == JitMode::On || (mode == JitMode::Auto && runs >= threshold);
+        if(is_hot && has_tried_to_compile == false)
+        {
+            has_tried_to_compile = true;
+            native = CompileNative(*ast);
+        }
+
+        if(native)
+        {
+            return native->Run();
+        }
+
+        return interpreter.Evaluate(*ast);
+    }
+
+
+    bool
+    TieredExpression::IsNative() const
+    {
+        return native.has_value();
+    }
+}
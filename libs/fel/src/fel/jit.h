@@ -0,0 +1,90 @@
+#ifndef FEL_JIT_H
+#define FEL_JIT_H
+
+#include <cstddef>
+#include <optional>
+
+#include "fel/ast.h"
+#include "fel/interpreter.h"
+#include "fel/value.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    // native code is only generated for x86-64 linux, on other platforms
+    // everything is run by the interpreter
+    bool
+    IsJitSupported();
+
+
+    // a expression compiled to machine code in executable pages
+    struct NativeCode
+    {
+        NativeCode(void* a_memory, std::size_t a_size, StaticType a_type);
+        ~NativeCode();
+
+        NativeCode(NativeCode&& rhs) noexcept;
+        NativeCode& operator=(NativeCode&& rhs) noexcept;
+        NativeCode(const NativeCode&) = delete;
+        NativeCode& operator=(const NativeCode&) = delete;
+
+        // native code can't fail, only expressions without errors are
+        // compiled
+        Value
+        Run() const;
+
+        void* memory;
+        std::size_t size;
+
+        // the type of the result, int, number or bool
+        StaticType type;
+    };
+
+
+    // compile the expression if every part of it is a int, number or bool
+    // that is known before running it, if the ast has no types they are
+    // inferred. Strings and expressions that could fail aren't compiled
+    std::optional<NativeCode>
+    CompileNative(const Ast& ast);
+
+
+    enum class JitMode
+    {
+        // always run the interpreter
+        Off,
+
+        // compile when it has been run enough times
+        Auto,
+
+        // compile before the first run
+        On
+    };
+
+
+    // runs a expression with the interpreter until it's hot and then with
+    // native code, if it can't be compiled the interpreter is used
+    struct TieredExpression
+    {
+        static constexpr std::size_t DefaultThreshold = 100;
+
+        TieredExpression(const Ast* a_ast, Log* log, JitMode a_mode, std::size_t a_threshold = DefaultThreshold);
+
+        Value
+        Evaluate();
+
+        bool
+        IsNative() const;
+
+        const Ast* ast;
+        JitMode mode;
+        std::size_t threshold;
+        std::size_t runs = 0;
+        bool has_tried_to_compile = false;
+        std::optional<NativeCode> native;
+        Interpreter interpreter;
+    };
+}
+
+#endif  // FEL_JIT_H
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/jit.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+
+using namespace fel;
+
+
+TEST_CASE("jit", "[jit]")
+{
+    if(IsJitSupported() == false) { return; }
+
+    // native code should give the same result as the interpreter
+    const std::vector<std::string> sources =
+    {
+        "1 + 2 * 3", "(1 + 2) * 3", "-4 - -2", "7 / 2", "1.5 * 2", "2 * 1.5 + 1", "-(2.5 / 2) - 1",
+        "1 < 2", "2 < 1", "2.5 >= 2", "2 <= 2", "3 > 3.5", "3 == 3", "3 != 3", "true == false", "true != false",
+        "null == null", "null != 1", "!null", "!0", "!!true", "!'a'", "(60 * 60 * 24) - 2147483647"
+    };
+
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+
+        Log log;
+        auto parser = Parser{file, &log};
+        const auto ast = parser.Parse();
+        REQUIRE(ast);
+
+        const auto expected = Interpreter{&log}.Evaluate(*ast);
+        const auto native = CompileNative(*ast);
+        REQUIRE(native);
+        const auto result = native->Run();
+
+        CHECK(result.GetType() == expected.GetType());
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(log.IsEmpty());
+    }
+}
+
+
+TEST_CASE("jit-fallback", "[jit]")
+{
+    // strings and errors are left to the interpreter
+    for(const auto& source: {"'a' + 'b'", "1 + null", "1 == 1.0", "'a' == 'a'", "null"})
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+
+        Log log;
+        auto parser = Parser{file, &log};
+        const auto ast = parser.Parse();
+        REQUIRE(ast);
+        CHECK_FALSE(CompileNative(*ast));
+
+        auto expression = TieredExpression{&*ast, &log, JitMode::On};
+        expression.Evaluate();
+        CHECK_FALSE(expression.IsNative());
+    }
+}
+
+
+TEST_CASE("jit-modulo", "[jit]")
+{
+    // modulo can fail so it's left to the interpreter that reports it
+    Log log;
+    const auto file = File{"source", std::string{"7 + 0"}};
+    auto parser = Parser{file, &log};
+    auto ast = parser.Parse();
+    REQUIRE(ast);
+    ast->nodes[ast->root].op = TokenType::Mod;
+    CHECK_FALSE(CompileNative(*ast));
+
+    auto expression = TieredExpression{&*ast, &log, JitMode::On};
+    CHECK(expression.Evaluate().IsNull());
+    CHECK_FALSE(expression.IsNative());
+    REQUIRE_FALSE(log.IsEmpty());
+    CHECK(log.entries[0].type == log::Type::UndefinedModulo);
+
+    // constants that only need the type of a operand that can fail
+    for(const auto& source: {"!(7 + 0)", "null == (7 + 0)", "(7 + 0) != null", "null == !x"})
+    {
+        INFO(source);
+        const auto constant_file = File{"source", std::string{source}};
+        Log constant_log;
+        auto constant_parser = Parser{constant_file, &constant_log};
+        auto constant = constant_parser.Parse();
+        REQUIRE(constant);
+        for(auto& node: constant->nodes)
+        {
+            if(node.type == NodeType::Binary && node.op == TokenType::Plus) { node.op = TokenType::Mod; }
+        }
+        CHECK_FALSE(CompileNative(*constant));
+
+        Log expected_log;
+        const auto expected = Interpreter{&expected_log}.Evaluate(*constant);
+
+        auto tiered = TieredExpression{&*constant, &constant_log, JitMode::On};
+        const auto result = tiered.Evaluate();
+        CHECK_FALSE(tiered.IsNative());
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(constant_log.entries == expected_log.entries);
+        CHECK_FALSE(constant_log.IsEmpty());
+    }
+}
+
+
+TEST_CASE("jit-tiering", "[jit]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"1 + 2"}};
+    auto parser = Parser{file, &log};
+    const auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    auto off = TieredExpression{&*ast, &log, JitMode::Off, 2};
+    auto tiered = TieredExpression{&*ast, &log, JitMode::Auto, 3};
+    for(int i = 0; i < 3; i += 1)
+    {
+        CHECK(Stringify(off.Evaluate()) == "3");
+        CHECK(Stringify(tiered.Evaluate()) == "3");
+        CHECK(tiered.IsNative() == (IsJitSupported() && i == 2));
+    }
+    CHECK_FALSE(off.IsNative());
+}
@@ -1,351 +1,219 @@
 #include "lexer.h"
 
-#include <sstream>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <utility>
 
 #include "fel/log.h"
+#include "fel/symboltable.h"
+#include "fel/syntax.h"
 
 namespace fel
 {
-    std::string ToString(const TokenType tt)
-    {
-        switch(tt)
-        {
-            #define X(x) case TokenType::x: return #x
-
-            X(Unknown);
-            X(BeginBrace);
-            X(EndBrace);
-            X(OpenParen);
-            X(CloseParen);
-            X(OpenBracket);
-            X(CloseBracket);
-            
-            X(Plus);
-            X(Minus);
-            X(Mult);
-            X(Div);
-            X(Comma);
-            X(Colon);
-            X(Term);
-
-            X(Dot);
-            X(DotDot);
-            X(Equal);
-            X(Assign);
-            X(Less);
-            X(LessEqual);
-            X(Greater);
-            X(GreaterEqual);
-
-
-            X(Not);
-            X(BitNot);
-            X(And);
-            X(Or);
-            X(BitAnd);
-            X(BitOr);
-
-            X(String);
-
-            X(Identifier);
-
-            X(KeywordIf);
-            X(KeywordElse);
-            X(KeywordFor);
-            X(KeywordFunction);
-            X(KeywordVar);
-            X(KeywordTrue);
-            X(KeywordFalse);
-            X(KeywordNull);
-            X(KeywordReturn);
-
-            X(Int);
-            X(Number);
-            
-            X(EndOfStream);
-
-            #undef X
-        default:
-            return "<unknown>";
-        }
-    }
+    static_assert(sizeof(Token) <= 16, "tokens should be kept small");
 
 
     Token::Token
     (
         TokenType t,
-        const std::string& lex,
-        std::shared_ptr<Object> lit,
-        const Where& w
+        std::uint32_t o,
+        std::uint32_t len,
+        FileId f,
+        std::uint8_t fl
     )
         : type(t)
-        , lexeme(lex)
-        , literal(lit)
-        , where(w)
-    {
-    }
-
-
-    Lexer::Lexer(const File& a_file, Log* a_log) : file(a_file), log(a_log)
+        , flags(fl)
+        , offset(o)
+        , length(len)
+        , file(f)
     {
     }
 
 
-    namespace
+    std::string_view
+    Token::GetLexeme() const
     {
-        bool
-        IsNewline(char c)
+        const auto data = GetFileData(file);
+        if(offset + length > data.size())
         {
-            switch(c)
-            {
-            case '\r': case '\n':
-                return true;
-            default:
-                return false;
-            }
+            // the file is gone
+            return {};
         }
+        return lexer_core::GetLexeme(type, flags, data.substr(offset, length));
+    }
 
 
-        bool
-        IsWhitespace(char c)
-        {
-            switch(c)
-            {
-            case ' ':
-            case '\t':
-            case '\r':
-            case '\n':
-                return true;
-
-            default:
-                return false;
-            }
-        }
+    Where
+    Token::GetWhere() const
+    {
+        return Where{file, GetLocation(file, offset)};
+    }
 
 
-        bool
-        IsAlpha(char c)
-        {
-            if(c >='a' && c<='z') return true;
-            if(c >='A' && c<='Z') return true;
-            return c == '_';
-        }
+    bool
+    DecodeInt(std::string_view lexeme, int* value)
+    {
+        const auto end = lexeme.data() + lexeme.size();
+        const auto result = std::from_chars(lexeme.data(), end, *value);
+        return result.ec == std::errc{} && result.ptr == end;
+    }
 
 
-        bool
-        IsNumeric(char c)
+    bool
+    DecodeNumber(std::string_view lexeme, float* value)
+    {
+#if defined(__cpp_lib_to_chars)
+        const auto end = lexeme.data() + lexeme.size();
+        const auto result = std::from_chars(lexeme.data(), end, *value);
+        return result.ec == std::errc{} && result.ptr == end;
+#else
+        // the float from_chars is missing before gcc 11 and in older libc++.
+        // The lexeme isn't null terminated and the locale is never changed so
+        // strtof parses it like from_chars does
+        const auto str = std::string{lexeme};
+        char* end = nullptr;
+        errno = 0;
+        const auto parsed = std::strtof(str.c_str(), &end);
+        if(errno == ERANGE || str.empty() || end != str.c_str() + str.size())
         {
-            if(c >='0' && c<='9') return true;
             return false;
         }
+        *value = parsed;
+        return true;
+#endif
+    }
 
 
-
-        bool
-        PeekBlockComment(FilePointer* file)
+    std::string
+    DecodeString(const Token& token)
+    {
+        const auto lexeme = token.GetLexeme();
+        if((token.flags & token_flags::HasEscapes) == 0)
         {
-            return file->Peek() == '/' && file->Peek(2) == '*';
+            return std::string{lexeme};
         }
 
-        void
-        EatBlockComment(FilePointer* file)
+        std::string str;
+        str.reserve(lexeme.size());
+        for(std::size_t i=0; i<lexeme.size(); i+=1)
         {
-            file->Read();
-
-            while(file->Peek() !=0 && !(file->Peek() == '*' && file->Peek(2) == '/'))
+            // todo(Gustav): handle escape characters
+            if(lexeme[i] == syntax::escape && i+1 < lexeme.size())
             {
-                if(PeekBlockComment(file))
-                {
-                    EatBlockComment(file);
-                }
-                else
-                {
-                    file->Read();
-                }
+                i += 1;
             }
-            file->Read();
-            file->Read();
+            str += lexeme[i];
         }
+        return str;
+    }
 
 
-        void
-        EatWhitespace(FilePointer* file)
+    Value
+    GetLiteral(const Token& token)
+    {
+        switch(token.type)
         {
-            while(true)
+        case TokenType::Int:
             {
-                if(IsWhitespace(file->Peek()))
-                {
-                    file->Read();
-                }
-                else if(file->Peek() == '/' && file->Peek(2) == '/')
-                {
-                    while(!IsNewline(file->Peek()) && file->Peek() != 0)
-                    {
-                        file->Read();
-                    }
-                }
-                else if(PeekBlockComment(file))
-                {
-                    EatBlockComment(file);
-                }
-                else
+                // left as 0 if it doesn't fit
+                int value = 0;
+                DecodeInt(token.GetLexeme(), &value);
+                return Value::FromInt(value);
+            }
+        case TokenType::Number:
+            {
+                float value = 0;
+                DecodeNumber(token.GetLexeme(), &value);
+                return Value::FromFloat(value);
+            }
+        case TokenType::String:
+            {
+                // the symbol table never shrinks so only short strings that
+                // are likely to repeat are kept there
+                auto text = DecodeString(token);
+                if(text.size() > MaxInternedLiteral)
                 {
-                    return;
+                    return Value::FromString(std::move(text));
                 }
+                return Value::FromSymbol(Intern(text));
             }
+        default:
+            return {};
         }
+    }
 
 
-        Token SingleChar(FilePointer* file, TokenType tt)
+    Lexer::Lexer(const File& a_file, Log* a_log) : file(a_file), log(a_log)
+    {
+        if(IsTooLarge(a_file))
         {
-            const auto location = Where{*file};
-            const auto c = file->Read();
-            return {tt, std::string(1, c), nullptr, location};
+            ReportTooLarge(a_file, log);
         }
+    }
 
 
-        Token CharAndChar(FilePointer* file, TokenType one_char, char second_char, TokenType two_chars)
-        {
-            const auto location = Where{*file};
-            auto first_char = std::string(1, file->Read());
-            if(file->Peek() == second_char)
-            {
-                file->Read();
-                return {two_chars, first_char + std::string(1, second_char), nullptr, location};
-            }
-            return {one_char, first_char, nullptr, location};
-        }
+    bool
+    IsTooLarge(const File& file)
+    {
+        return file.data.size() > MaxFileSize;
+    }
 
 
-        Token ParseString(Log* log, FilePointer* file)
-        {
-            const auto location = Where{*file};
-            std::ostringstream buffer;
-            auto end = file->Read();
-            while(file->Peek() != end)
-            {
-                auto c = file->Read();
-                if( c == 0)
-                {
-                    log->AddError(*file, log::Type::EosInString, {});
-                    const auto str = buffer.str();
-                    return {TokenType::String, str, Object::FromString(str), location};
-                }
-                if(c == '\\')
-                {
-                    // todo(Gustav): handle escape characters
-                    c = file->Read();
-                }
+    void
+    ReportTooLarge(const File& file, Log* log)
+    {
+        log->AddError(Where{file.id, Location{1, 0}}, log::Type::FileTooLarge, {std::to_string(file.data.size())});
+    }
 
-                buffer << c;
-            }
-            file->Read();
-            const auto str = buffer.str();
-            return {TokenType::String, str, Object::FromString(str), location};
+
+    namespace
+    {
+        void
+        UnknownCharacter(Log* log, const FilePointer& file, std::size_t start)
+        {
+            const auto c = file.file.data[start];
+            const auto unknown_character = std::string{1, c};
+            log->AddError(file, log::Type::UnknownCharacter, {unknown_character});
         }
     }
 
 
     Token Lexer::GetNextToken()
     {
-        EatWhitespace(&file);
-
-        switch(file.Peek())
+        if(IsTooLarge(file.file))
         {
-        case 0:
-            return {TokenType::EndOfStream, "", nullptr, Where{file}};
-
-        case '{': return SingleChar(&file, TokenType::BeginBrace);
-        case '}': return SingleChar(&file, TokenType::EndBrace);
-        case '(': return SingleChar(&file, TokenType::OpenParen);
-        case ')': return SingleChar(&file, TokenType::CloseParen);
-        case '[': return SingleChar(&file, TokenType::OpenBracket);
-        case ']': return SingleChar(&file, TokenType::CloseBracket);
-        case '+': return SingleChar(&file, TokenType::Plus);
-        case '-': return SingleChar(&file, TokenType::Minus);
-        case '*': return SingleChar(&file, TokenType::Mult);
-        case '/': return SingleChar(&file, TokenType::Div);
-        case '%': return SingleChar(&file, TokenType::Mod);
-        case ',': return SingleChar(&file, TokenType::Comma);
-        case ':': return SingleChar(&file, TokenType::Colon);
-        case ';': return SingleChar(&file, TokenType::Term);
-
-        case '.': return CharAndChar(&file, TokenType::Dot, '.', TokenType::DotDot);
-        case '=': return CharAndChar(&file, TokenType::Assign, '=', TokenType::Equal);
-        case '<': return CharAndChar(&file, TokenType::Less, '=', TokenType::LessEqual);
-        case '>': return CharAndChar(&file, TokenType::Greater, '=', TokenType::GreaterEqual);
-
-        case '!': return CharAndChar(&file, TokenType::Not, '=', TokenType::NotEqual);
-        case '~': return SingleChar(&file, TokenType::BitNot);
-        case '&': return CharAndChar(&file, TokenType::BitAnd, '&', TokenType::And);
-        case '|': return CharAndChar(&file, TokenType::BitOr, '|', TokenType::Or);
-        
-        case '"':
-        case '\'':
-            return ParseString(log, &file);
-        
+            return {TokenType::EndOfStream, 0, 0, file.file.id};
+        }
 
-        default:
-            if(IsAlpha(file.Peek()))
-            {
-                std::ostringstream buffer;
-                const auto location = Where{file};
-                buffer << file.Read();
-                while( IsAlpha(file.Peek()) || IsNumeric(file.Peek()) )
-                {
-                    buffer << file.Read();
-                }
-                auto s = buffer.str();
-                if(s == "if") { return {TokenType::KeywordIf, s, nullptr, location}; }
-                else if(s == "if") { return {TokenType::KeywordIf, s, nullptr, location}; }
-                else if(s == "else") { return {TokenType::KeywordElse, s, nullptr, location}; }
-                else if(s == "for") { return {TokenType::KeywordFor, s, nullptr, location}; }
-                else if(s == "fun") { return {TokenType::KeywordFunction, s, nullptr, location}; }
-                else if(s == "return") { return {TokenType::KeywordReturn, s, nullptr, location}; }
-                else if(s == "while") { return {TokenType::KeywordWhile, s, nullptr, location}; }
-                else if(s == "print") { return {TokenType::KeywordPrint, s, nullptr, location}; }
-                else if(s == "var") { return {TokenType::KeywordVar, s, nullptr, location}; }
-                else if(s == "true") { return {TokenType::KeywordTrue, s, nullptr, location}; }
-                else if(s == "false") { return {TokenType::KeywordFalse, s, nullptr, location}; }
-                else if(s == "null") { return {TokenType::KeywordNull, s, nullptr, location}; }
-                else
-                {
-                    return {TokenType::Identifier, s, nullptr, location};
-                }
-                
-            }
-            else if(IsNumeric(file.Peek()))
-            {
-                const auto location = Where{file};
-                std::ostringstream buffer;
-                buffer << file.Read();
-                while( IsNumeric(file.Peek()) )
-                {
-                    buffer << file.Read();
-                }
-                if(file.Peek() == '.')
-                {
-                    buffer << file.Read();
-                    
-                    while( IsNumeric(file.Peek()) )
-                    {
-                        buffer << file.Read();
-                    }
-                    auto s = buffer.str();
-                    return {TokenType::Number, s, Object::FromFloat(std::stof(s)), location};
-                }
-                auto s = buffer.str();
-                return {TokenType::Int, s, Object::FromInt(std::stoi(s)), location};
-            }
-            else
-            {
-                const auto location = Where{file};
-                auto c = file.Read();
-                const auto unknown_character = std::string{1, c};
-                log->AddError(file, log::Type::UnknownCharacter, {unknown_character});
-                return {TokenType::Unknown, unknown_character, nullptr, location};
-            }
+        auto state = lexer_core::SkipState{};
+        const auto skipped = lexer_core::SkipWhitespace(file.file.data, file.next_index, &state, true);
+        const auto start = skipped.index;
+
+        const auto scanned = lexer_core::ScanToken(file.file.data, start);
+        file.SkipTo(scanned.end);
+
+        switch(scanned.error)
+        {
+        case lexer_core::ScanError::UnknownCharacter:
+            UnknownCharacter(log, file, start);
+            break;
+        case lexer_core::ScanError::EosInString:
+            log->AddError(file, log::Type::EosInString, {});
+            break;
+        case lexer_core::ScanError::None:
+            break;
         }
+
+        return
+        {
+            scanned.type,
+            static_cast<std::uint32_t>(start),
+            static_cast<std::uint32_t>(scanned.end - start),
+            file.file.id,
+            scanned.flags
+        };
     }
 
 
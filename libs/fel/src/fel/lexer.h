@@ -1,12 +1,19 @@
 #ifndef FEL_LEXER_H
 #define FEL_LEXER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
+#include <memory>
 
 #include "fel/file.h"
-#include "fel/object.h"
+#include "fel/filetable.h"
+#include "fel/lexer_core.h"
+#include "fel/tokentype.h"
+#include "fel/value.h"
 #include "fel/where.h"
 
 namespace fel
@@ -14,64 +21,77 @@ namespace fel
     struct Log;
 
 
-    enum class TokenType
+    // a token doesn't own any memory, the lexeme is a view into the file
+    // data and literals are decoded when requested
+    struct Token
     {
-        Unknown,
-        BeginBrace, EndBrace, // {}
-        OpenParen, CloseParen, // ()
-        OpenBracket, CloseBracket, // []
-        
-        Plus, Minus, Mult, Div, Mod, Comma, Colon,
-        Term, // ;
-
-        Dot, DotDot,
-        Equal, Assign,
-        Less, LessEqual,
-        Greater, GreaterEqual,
-
-        Not, NotEqual,
-        And, Or, BitNot, BitAnd, BitOr,
-
-        String,
+        Token
+        (
+            TokenType t,
+            std::uint32_t o,
+            std::uint32_t len,
+            FileId f,
+            std::uint8_t fl = 0
+        );
 
-        Identifier,
+        TokenType type;
+        std::uint8_t flags;
+        std::uint32_t offset;
+        std::uint32_t length;
+        FileId file;
+
+        // the location is resolved from the offset on request
+        Where
+        GetWhere() const;
+
+        // the source text of the token, strings are returned without quotes
+        std::string_view
+        GetLexeme() const;
+    };
 
-        KeywordIf, KeywordElse, KeywordFor, KeywordFunction, KeywordVar,
-        KeywordTrue, KeywordFalse, KeywordNull, KeywordReturn,
-        KeywordWhile,
 
-        // todo(Gustav): remove this when functions work
-        KeywordPrint,
+    // decode the value of a Int or Number token directly from the source,
+    // returns false if the value doesn't fit
+    bool
+    DecodeInt(std::string_view lexeme, int* value);
 
-        Int, Number,
-        
-        EndOfStream
-    };
+    bool
+    DecodeNumber(std::string_view lexeme, float* value);
 
 
+    // the text of a String token with the escape characters removed
     std::string
-    ToString(const TokenType tt);
+    DecodeString(const Token& token);
 
 
-    struct Token
-    {
-        Token(TokenType t, const std::string& lex, std::shared_ptr<Object> lit, const Where& w);
+    // string literals up to this many bytes are interned, longer ones are
+    // counted strings that are freed with the last value that uses them
+    constexpr std::size_t MaxInternedLiteral = 32;
 
-        TokenType type;
-        std::string lexeme;
-        std::shared_ptr<Object> literal;
-        Where where;
-    };
+
+    // decode the literal value of a Int, Number or String token, values that
+    // doesn't fit are decoded as 0
+    Value
+    GetLiteral(const Token& token);
 
 
     template<typename Stream>
     Stream& operator<<(Stream& stream, const Token& token)
     {
-        stream << ToString(token.type) << ": " << token.lexeme;
+        stream << ToString(token.type) << ": " << token.GetLexeme();
         return stream;
     }
 
 
+    // the offsets of the tokens doesn't fit, see MaxFileSize
+    bool
+    IsTooLarge(const File& file);
+
+    void
+    ReportTooLarge(const File& file, Log* log);
+
+
+    // a file that is too large is reported and lexed as empty
     struct Lexer
     {
         FilePointer file;
@@ -5,6 +5,10 @@
 #include "fel/lexer.h"
 #include "fel/file.h"
 #include "fel/log.h"
+#include "fel/parallellexer.h"
+#include "fel/streamlexer.h"
+#include "fel/threadpool.h"
+#include "fel/tokenbuffer.h"
 
 using namespace fel;
 using Catch::Matchers::Equals;
@@ -22,7 +26,7 @@ namespace
     {
         TestToken(const Token& token)
             : type(token.type)
-            , text(token.lexeme)
+            , text(std::string{token.GetLexeme()})
         {
         }
 
@@ -273,3 +277,289 @@ TEST_CASE("lexer", "[lexer]")
         );
     }
 }
+
+
+TEST_CASE("lexer-literals", "[lexer]")
+{
+    Log log;
+    const auto file = S("'dog' \"c\\\"at\" 42 2.5");
+    auto reader = LexerReader{file, &log};
+    const auto tokens = GetAllTokensInFile(&reader);
+    REQUIRE(tokens.size() == 4);
+    CHECK(log.IsEmpty());
+
+    CHECK(tokens[0].GetLexeme() == "dog");
+    CHECK(Stringify(GetLiteral(tokens[0])) == "dog");
+
+    CHECK(tokens[1].GetLexeme() == "c\\\"at");
+    CHECK(Stringify(GetLiteral(tokens[1])) == "c\"at");
+
+    CHECK(Stringify(GetLiteral(tokens[2])) == "42");
+    CHECK(Stringify(GetLiteral(tokens[3])) == "2.5");
+}
+
+
+TEST_CASE("lexer-keywords", "[lexer]")
+{
+    Log log;
+    CHECK_THAT
+    (
+        Tokenize(S("while print iff whiles prin _if if2"), &log),
+        Equals<TestToken>
+        (
+            {
+                TokenType::KeywordWhile,
+                TokenType::KeywordPrint,
+                {TokenType::Identifier, "iff"},
+                {TokenType::Identifier, "whiles"},
+                {TokenType::Identifier, "prin"},
+                {TokenType::Identifier, "_if"},
+                {TokenType::Identifier, "if2"}
+            }
+        )
+    );
+    CHECK(log.IsEmpty());
+}
+
+
+TEST_CASE("lexer-deep-comments", "[lexer]")
+{
+    const std::size_t depth = 1000000;
+    std::string source;
+    for(std::size_t i=0; i<depth; i+=1) { source += "/*"; }
+    source += " 1 ";
+    for(std::size_t i=0; i<depth; i+=1) { source += "*/"; }
+    source += "\n42";
+
+    Log log;
+    const auto file = S(source);
+    auto reader = LexerReader{file, &log};
+    const auto tokens = GetAllTokensInFile(&reader);
+    REQUIRE(tokens.size() == 1);
+    CHECK(tokens[0].GetLexeme() == "42");
+    CHECK(tokens[0].GetWhere().location.line == 2);
+    CHECK(tokens[0].GetWhere().location.column == 0);
+}
+
+
+TEST_CASE("lexer-tokenbuffer", "[lexer]")
+{
+    Log log;
+    const auto file = S("if a + 'b' + 3 == c");
+    const auto tokens = LexFile(file, &log);
+    CHECK(log.IsEmpty());
+
+    REQUIRE(tokens.GetSize() == 8);
+    CHECK(tokens.Count(TokenType::Plus) == 2);
+    CHECK(tokens.Count(TokenType::Identifier) == 2);
+    CHECK(tokens.Count(TokenType::EndOfStream) == 0);
+
+    CHECK(tokens.types[0] == TokenType::KeywordIf);
+    CHECK(tokens.GetLexeme(1) == "a");
+    CHECK(tokens.GetLexeme(3) == "b");
+    CHECK(tokens.GetLiteral(1).IsNull());
+    CHECK(Stringify(tokens.GetLiteral(3)) == "b");
+    CHECK(Stringify(tokens.GetLiteral(5)) == "3");
+    CHECK(tokens.GetToken(7).GetWhere().location.column == 18);
+}
+
+
+TEST_CASE("lexer-tokenbuffer-numbers", "[lexer]")
+{
+    Log log;
+    const auto file = S("2147483647 0042 2.5 3. 99999999999 1.0\n1" + std::string(50, '0') + ".0");
+    const auto tokens = LexFile(file, &log);
+
+    REQUIRE(tokens.GetSize() == 7);
+
+    // decoded when lexed, a number that doesn't fit is 0
+    std::vector<std::string> values;
+    for(std::size_t index = 0; index < tokens.GetSize(); index += 1)
+    {
+        values.emplace_back(Stringify(tokens.GetLiteral(index)));
+    }
+    CHECK(values == std::vector<std::string>{"2147483647", "42", "2.5", "3", "0", "1", "0"});
+    CHECK(tokens.literals[0] == 2147483647u);
+    CHECK((tokens.flags[4] & token_flags::OutOfRange) != 0);
+    CHECK((tokens.flags[3] & token_flags::OutOfRange) == 0);
+
+    // reported once by the lexer instead of thrown
+    REQUIRE(log.entries.size() == 2);
+    CHECK(log.entries[0].type == log::Type::NumberOutOfRange);
+    CHECK(log.entries[0].arguments == std::vector<std::string>{"99999999999"});
+    CHECK(log.entries[0].where.location == Location{1, 23});
+    CHECK(log.entries[1].where.location == Location{2, 0});
+}
+
+
+TEST_CASE("lexer-stream", "[lexer]")
+{
+    const auto source = std::string
+    {
+        "if a /* nested /* comment */ with\n lines */ + 'str\\'ing' // to end\n"
+        "\t3.14 != abc_123 /**/ \"x\"\r\n>= 4 @ 'unterminated"
+    };
+
+    Log file_log;
+    const auto file = S(source);
+    auto lexer = Lexer{file, &file_log};
+
+    std::vector<Token> expected;
+    for(auto token = lexer.GetNextToken(); token.type != TokenType::EndOfStream; token = lexer.GetNextToken())
+    {
+        expected.emplace_back(token);
+    }
+    REQUIRE(expected.size() == 12);
+
+    // tiny chunks makes every token, comment and string cross a chunk boundary
+    for(const std::size_t chunk_size: std::vector<std::size_t>{1, 2, 3, 7, 64})
+    {
+        INFO("chunk size " << chunk_size);
+        Log log;
+        std::istringstream stream{source};
+        auto stream_lexer = StreamLexer{"source", ReadFromStream(stream), &log, chunk_size};
+
+        for(const auto& e: expected)
+        {
+            const auto token = stream_lexer.GetNextToken();
+            CHECK(token.type == e.type);
+            CHECK(token.flags == e.flags);
+            CHECK(token.offset == e.offset);
+            CHECK(token.GetLexeme() == e.GetLexeme());
+            CHECK(token.location == e.GetWhere().location);
+        }
+        CHECK(stream_lexer.GetNextToken().type == TokenType::EndOfStream);
+        CHECK(stream_lexer.GetNextToken().type == TokenType::EndOfStream);
+
+        // the stream isn't a registered file so only the printed log can be compared
+        std::ostringstream printed;
+        std::ostringstream file_printed;
+        printed << log;
+        file_printed << file_log;
+        CHECK(printed.str() == file_printed.str());
+    }
+}
+
+
+TEST_CASE("lexer-parallel", "[lexer]")
+{
+    // pieces that make a chunk boundary fall inside strings and comments
+    const std::vector<std::string> pieces =
+    {
+        "abc ", "42\n", "3.5 ", "'a\nb' ", "\"x\\\"y\" ", "/* a\n/* 'b\n */ c */ ",
+        "// 'no string\n", "+ ", "== ", "@", "\n", "\"\n\n\" ", "/*\n*/", "99999999999 "
+    };
+
+    std::string source;
+    std::uint32_t seed = 42;
+    for(int i=0; i<4000; i+=1)
+    {
+        seed = seed * 1664525 + 1013904223;
+        source += pieces[(seed >> 16) % pieces.size()];
+    }
+    source += "'unterminated\n end";
+
+    const auto file = S(source);
+    Log serial_log;
+    const auto serial = LexFile(file, &serial_log);
+
+    auto pool = ThreadPool{4};
+    for(const std::size_t chunk_size: std::vector<std::size_t>{1, 16, 100, 1000, 0})
+    {
+        INFO("chunk size " << chunk_size);
+        Log log;
+        const auto parallel = LexFileParallel(file, &log, &pool, chunk_size);
+
+        REQUIRE(parallel.GetSize() == serial.GetSize());
+        CHECK(parallel.types == serial.types);
+        CHECK(parallel.flags == serial.flags);
+        CHECK(parallel.offsets == serial.offsets);
+        CHECK(parallel.lengths == serial.lengths);
+        CHECK(parallel.literals == serial.literals);
+        CHECK(log.entries == serial_log.entries);
+    }
+}
+
+
+TEST_CASE("lexer-too-large", "[lexer]")
+{
+    // only the size is looked at, the data is never read
+    const char text[] = "1 + 2";
+    const auto file = File{"large", std::string_view{text, MaxFileSize + 1}, nullptr};
+
+    Log log;
+    auto lexer = Lexer{file, &log};
+    CHECK(lexer.GetNextToken().type == TokenType::EndOfStream);
+    REQUIRE(log.entries.size() == 1);
+    CHECK(log.entries[0].type == log::Type::FileTooLarge);
+
+    Log parallel_log;
+    auto pool = ThreadPool{2};
+    CHECK(LexFileParallel(file, &parallel_log, &pool).GetSize() == 0);
+    CHECK(parallel_log.entries.size() == 1);
+}
+
+
+TEST_CASE("lexer-stream-read-error", "[lexer]")
+{
+    // the tokens read before the error are kept
+    bool has_read = false;
+    const auto reader = [&](char* destination, std::size_t, std::string* error) -> std::size_t
+    {
+        if(has_read)
+        {
+            *error = "disk on fire";
+            return 0;
+        }
+        has_read = true;
+        destination[0] = '1';
+        destination[1] = ' ';
+        return 2;
+    };
+
+    Log log;
+    auto lexer = StreamLexer{"source", reader, &log, 4};
+    CHECK(lexer.GetNextToken().type == TokenType::Int);
+    CHECK(lexer.GetNextToken().type == TokenType::EndOfStream);
+    REQUIRE(log.entries.size() == 1);
+    CHECK(log.entries[0].type == log::Type::ReadError);
+    CHECK(log.entries[0].arguments == std::vector<std::string>{"disk on fire"});
+
+    // the error doesn't move the locations of the tokens before it
+    bool has_read_lines = false;
+    const auto lines_reader = [&](char* destination, std::size_t, std::string* error) -> std::size_t
+    {
+        if(has_read_lines)
+        {
+            *error = "disk on fire";
+            return 0;
+        }
+        has_read_lines = true;
+        destination[0] = '1';
+        destination[1] = '\n';
+        destination[2] = '2';
+        return 3;
+    };
+    Log lines_log;
+    auto lines_lexer = StreamLexer{"source", lines_reader, &lines_log, 8};
+    const auto first = lines_lexer.GetNextToken();
+    CHECK(first.text == "1");
+    CHECK(first.location.line == 1);
+    CHECK(first.location.column == 0);
+    const auto second = lines_lexer.GetNextToken();
+    CHECK(second.text == "2");
+    CHECK(second.location.line == 2);
+    CHECK(second.location.column == 0);
+    CHECK(lines_lexer.GetNextToken().type == TokenType::EndOfStream);
+    REQUIRE(lines_log.entries.size() == 1);
+    CHECK(lines_log.entries[0].where.location.line == 2);
+    CHECK(lines_log.entries[0].where.location.column == 1);
+
+#ifndef _WIN32
+    Log descriptor_log;
+    auto bad_descriptor = StreamLexer{"source", ReadFromDescriptor(-1), &descriptor_log};
+    CHECK(bad_descriptor.GetNextToken().type == TokenType::EndOfStream);
+    REQUIRE(descriptor_log.entries.size() == 1);
+    CHECK(descriptor_log.entries[0].type == log::Type::ReadError);
+#endif
+}
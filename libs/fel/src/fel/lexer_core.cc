@@ -0,0 +1,207 @@
+#include "fel/lexer_core.h"
+
+#include "fel/lexer_tables.h"
+#include "fel/scan.h"
+#include "fel/syntax.h"
+
+namespace fel::lexer_core
+{
+    namespace
+    {
+        using lexer_tables::Byte;
+
+
+        bool
+        IsMarkerAt(std::string_view data, std::size_t index, std::string_view marker)
+        {
+            return index + 1 < data.size() && data[index] == marker[0] && data[index + 1] == marker[1];
+        }
+
+
+        // true if index is too close to the end to tell if a marker starts there
+        bool
+        IsMarkerUndecided(std::string_view data, std::size_t index, bool is_complete)
+        {
+            return !is_complete && index + 1 >= data.size();
+        }
+
+
+        ScanResult
+        ScanPunctuation(std::string_view data, std::size_t index)
+        {
+            const auto& entry = lexer_tables::punctuation_table[Byte(data[index])];
+            if(entry.second != 0 && index + 1 < data.size() && data[index + 1] == entry.second)
+            {
+                return {entry.two, 0, index + 2, ScanError::None};
+            }
+            if(entry.one == TokenType::Unknown)
+            {
+                return {TokenType::Unknown, 0, index + 1, ScanError::UnknownCharacter};
+            }
+            return {entry.one, 0, index + 1, ScanError::None};
+        }
+
+
+        ScanResult
+        ScanString(std::string_view data, std::size_t index)
+        {
+            const auto quote = data[index];
+            std::uint8_t flags = 0;
+            auto i = index + 1;
+            while(true)
+            {
+                if(i >= data.size())
+                {
+                    flags |= token_flags::Unterminated;
+                    return {TokenType::String, flags, data.size(), ScanError::EosInString};
+                }
+
+                const auto c = data[i];
+                if(c == quote)
+                {
+                    return {TokenType::String, flags, i + 1, ScanError::None};
+                }
+
+                i += 1;
+                if(c == 0)
+                {
+                    flags |= token_flags::Unterminated;
+                    return {TokenType::String, flags, i, ScanError::EosInString};
+                }
+                if(c == syntax::escape)
+                {
+                    flags |= token_flags::HasEscapes;
+                    if(i < data.size()) { i += 1; }
+                }
+            }
+        }
+    }
+
+
+    SkipResult
+    SkipWhitespace(std::string_view data, std::size_t index, SkipState* state, bool is_complete)
+    {
+        while(true)
+        {
+            if(state->in_line_comment)
+            {
+                index = scan::FindNewline(data, index);
+                if(index >= data.size() && !is_complete)
+                {
+                    return {index, true};
+                }
+                state->in_line_comment = false;
+            }
+            else if(state->block_comment_depth > 0)
+            {
+                // nested comments are tracked with a depth instead of recursion
+                index = scan::FindBlockCommentMarker(data, index);
+                if(index >= data.size() || data[index] == 0)
+                {
+                    if(!is_complete && index >= data.size())
+                    {
+                        return {index, true};
+                    }
+                    state->block_comment_depth = 0;
+                    return {index, false};
+                }
+                if(IsMarkerUndecided(data, index, is_complete))
+                {
+                    return {index, true};
+                }
+
+                if(IsMarkerAt(data, index, syntax::block_comment_end))
+                {
+                    state->block_comment_depth -= 1;
+                    index += 2;
+                }
+                else if(IsMarkerAt(data, index, syntax::block_comment_begin))
+                {
+                    state->block_comment_depth += 1;
+                    index += 2;
+                }
+                else
+                {
+                    index += 1;
+                }
+            }
+            else
+            {
+                index = scan::SkipWhitespace(data, index);
+                if(IsMarkerUndecided(data, index, is_complete))
+                {
+                    return {index, true};
+                }
+
+                if(IsMarkerAt(data, index, syntax::line_comment))
+                {
+                    state->in_line_comment = true;
+                    index += 2;
+                }
+                else if(IsMarkerAt(data, index, syntax::block_comment_begin))
+                {
+                    state->block_comment_depth = 1;
+                    index += 2;
+                }
+                else
+                {
+                    return {index, false};
+                }
+            }
+        }
+    }
+
+
+    ScanResult
+    ScanToken(std::string_view data, std::size_t index)
+    {
+        const auto first = index < data.size() ? data[index] : '\0';
+        switch(lexer_tables::start_table[Byte(first)])
+        {
+        case lexer_tables::Start::End:
+            return {TokenType::EndOfStream, 0, index, ScanError::None};
+
+        case lexer_tables::Start::Punctuation:
+            return ScanPunctuation(data, index);
+
+        case lexer_tables::Start::String:
+            return ScanString(data, index);
+
+        case lexer_tables::Start::Identifier:
+            {
+                const auto end = scan::SkipIdentifier(data, index + 1);
+                const auto text = data.substr(index, end - index);
+                return {lexer_tables::LookupKeyword(text), 0, end, ScanError::None};
+            }
+
+        case lexer_tables::Start::Number:
+            {
+                const auto end = scan::SkipDigits(data, index + 1);
+                if(end < data.size() && data[end] == syntax::decimal_point)
+                {
+                    return {TokenType::Number, 0, scan::SkipDigits(data, end + 1), ScanError::None};
+                }
+                return {TokenType::Int, 0, end, ScanError::None};
+            }
+
+        case lexer_tables::Start::Unknown:
+        default:
+            return {TokenType::Unknown, 0, index + 1, ScanError::UnknownCharacter};
+        }
+    }
+
+
+    std::string_view
+    GetLexeme(TokenType type, std::uint8_t flags, std::string_view text)
+    {
+        if(type != TokenType::String)
+        {
+            return text;
+        }
+
+        // strip the quotes
+        const std::size_t end_quote = (flags & token_flags::Unterminated) ? 0 : 1;
+        if(text.size() < 1 + end_quote) { return {}; }
+        return text.substr(1, text.size() - 1 - end_quote);
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef FEL_LEXER_CORE_H
+#define FEL_LEXER_CORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "fel/tokentype.h"
+
+// The lexing rules without any knowledge of where the data comes from, used
+// by the file lexer and the streaming lexer. All functions work on offsets
+// into the data.
+
+namespace fel::token_flags
+{
+    // the string contains escape characters and can't be used as a slice
+    constexpr std::uint8_t HasEscapes = 1 << 0;
+
+    // the string is missing the ending quote
+    constexpr std::uint8_t Unterminated = 1 << 1;
+
+    // set by the TokenBuffer when the number doesn't fit and was decoded as 0
+    constexpr std::uint8_t OutOfRange = 1 << 2;
+}
+
+
+namespace fel::lexer_core
+{
+    // where we are in whitespace and comments, needed to continue skipping
+    // when the data arrives in chunks
+    struct SkipState
+    {
+        int block_comment_depth = 0;
+        bool in_line_comment = false;
+    };
+
+
+    struct SkipResult
+    {
+        std::size_t index;
+
+        // the end of the data was reached before it could be decided where the
+        // next token starts, index is the first byte that needs to be kept
+        bool needs_more;
+    };
+
+
+    // skips whitespace and comments, if the data isn't complete more data
+    // might follow and needs_more is set instead of guessing
+    SkipResult
+    SkipWhitespace(std::string_view data, std::size_t index, SkipState* state, bool is_complete);
+
+
+    enum class ScanError : std::uint8_t
+    {
+        None, UnknownCharacter, EosInString
+    };
+
+
+    struct ScanResult
+    {
+        TokenType type;
+        std::uint8_t flags;
+
+        // the index after the token, errors are reported at this index
+        std::size_t end;
+        ScanError error;
+    };
+
+
+    // scans the token that starts at index, whitespace must have been skipped.
+    // if the token ends at the end of the data and more data might follow the
+    // caller needs to scan it again when it has more data
+    ScanResult
+    ScanToken(std::string_view data, std::size_t index);
+
+
+    // the lexeme of a token from the source text, strings are returned
+    // without the quotes
+    std::string_view
+    GetLexeme(TokenType type, std::uint8_t flags, std::string_view text);
+}
+
+#endif  // FEL_LEXER_CORE_H
@@ -0,0 +1,273 @@
+#ifndef FEL_LEXER_TABLES_H
+#define FEL_LEXER_TABLES_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "fel/syntax.h"
+#include "fel/tokentype.h"
+
+// Lookup tables for the lexer, generated at compile time from fel/syntax.h
+
+namespace fel::lexer_tables
+{
+    constexpr std::size_t
+    Byte(char c)
+    {
+        return static_cast<unsigned char>(c);
+    }
+
+
+    // ------------------------------------------------------------------------
+    // character classes
+
+    namespace char_flags
+    {
+        constexpr std::uint8_t Whitespace = 1 << 0;
+        constexpr std::uint8_t Newline = 1 << 1;
+        constexpr std::uint8_t IdentifierStart = 1 << 2;
+        constexpr std::uint8_t IdentifierPart = 1 << 3;
+        constexpr std::uint8_t Digit = 1 << 4;
+    }
+
+
+    constexpr std::array<std::uint8_t, 256>
+    MakeCharFlags()
+    {
+        std::array<std::uint8_t, 256> r = {};
+        for(std::size_t c = 0; c < 256; c += 1)
+        {
+            std::uint8_t f = 0;
+            if(c == ' ' || c == '\t' || c == '\r' || c == '\n') { f |= char_flags::Whitespace; }
+            if(c == '\r' || c == '\n') { f |= char_flags::Newline; }
+            if((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+            {
+                f |= char_flags::IdentifierStart | char_flags::IdentifierPart;
+            }
+            if(c >= '0' && c <= '9') { f |= char_flags::Digit | char_flags::IdentifierPart; }
+            r[c] = f;
+        }
+        return r;
+    }
+
+
+    constexpr auto char_flags_table = MakeCharFlags();
+
+
+    constexpr bool
+    Is(char c, std::uint8_t flags)
+    {
+        return (char_flags_table[Byte(c)] & flags) != 0;
+    }
+
+
+    // ------------------------------------------------------------------------
+    // punctuation, indexed by the first character
+
+    struct PunctuationEntry
+    {
+        TokenType one = TokenType::Unknown;
+        char second = 0;
+        TokenType two = TokenType::Unknown;
+    };
+
+
+    constexpr std::array<PunctuationEntry, 256>
+    MakePunctuation()
+    {
+        std::array<PunctuationEntry, 256> r = {};
+        for(const auto& p: syntax::punctuation)
+        {
+            auto& entry = r[Byte(p.text[0])];
+            if(p.text.size() == 1)
+            {
+                entry.one = p.type;
+            }
+            else
+            {
+                entry.second = p.text[1];
+                entry.two = p.type;
+            }
+        }
+        return r;
+    }
+
+
+    constexpr bool
+    IsValidPunctuation()
+    {
+        for(std::size_t i = 0; i < std::size(syntax::punctuation); i += 1)
+        {
+            const auto& lhs = syntax::punctuation[i];
+            if(lhs.text.empty() || lhs.text.size() > 2) { return false; }
+            if(Is(lhs.text[0], char_flags::Whitespace | char_flags::IdentifierPart)) { return false; }
+
+            for(std::size_t j = i + 1; j < std::size(syntax::punctuation); j += 1)
+            {
+                const auto& rhs = syntax::punctuation[j];
+                if(lhs.text == rhs.text) { return false; }
+
+                // only one two character operator per first character
+                const bool both_long = lhs.text.size() == 2 && rhs.text.size() == 2;
+                if(both_long && lhs.text[0] == rhs.text[0]) { return false; }
+            }
+        }
+        return true;
+    }
+
+
+    static_assert(IsValidPunctuation(), "punctuation must be unique and be one or two characters long");
+
+
+    constexpr auto punctuation_table = MakePunctuation();
+
+
+    // ------------------------------------------------------------------------
+    // what to lex, based on the first character of the token
+
+    enum class Start : std::uint8_t
+    {
+        End, Punctuation, String, Identifier, Number, Unknown
+    };
+
+
+    constexpr std::array<Start, 256>
+    MakeStart()
+    {
+        std::array<Start, 256> r = {};
+        for(std::size_t c = 0; c < 256; c += 1)
+        {
+            const auto ch = static_cast<char>(c);
+            if(c == 0) { r[c] = Start::End; }
+            else if(Is(ch, char_flags::IdentifierStart)) { r[c] = Start::Identifier; }
+            else if(Is(ch, char_flags::Digit)) { r[c] = Start::Number; }
+            else if(syntax::quotes.find(ch) != std::string_view::npos) { r[c] = Start::String; }
+            else if(punctuation_table[c].one != TokenType::Unknown || punctuation_table[c].second != 0)
+            {
+                r[c] = Start::Punctuation;
+            }
+            else { r[c] = Start::Unknown; }
+        }
+        return r;
+    }
+
+
+    constexpr auto start_table = MakeStart();
+
+
+    // ------------------------------------------------------------------------
+    // keywords, matched with a perfect hash found at compile time
+
+    constexpr std::size_t keyword_count = std::size(syntax::keywords);
+
+
+    constexpr std::size_t
+    MakeKeywordTableSize()
+    {
+        std::size_t size = 16;
+        while(size < keyword_count * 2) { size *= 2; }
+        return size;
+    }
+
+
+    constexpr std::size_t keyword_table_size = MakeKeywordTableSize();
+
+
+    struct KeywordHash
+    {
+        std::size_t first = 0;
+        std::size_t last = 0;
+    };
+
+
+    constexpr std::size_t
+    Hash(std::string_view s, const KeywordHash& h)
+    {
+        const auto mixed = Byte(s[0]) * h.first + Byte(s[s.size() - 1]) * h.last + s.size();
+        return mixed & (keyword_table_size - 1);
+    }
+
+
+    constexpr bool
+    IsPerfect(const KeywordHash& h)
+    {
+        for(std::size_t i = 0; i < keyword_count; i += 1)
+        {
+            for(std::size_t j = i + 1; j < keyword_count; j += 1)
+            {
+                if(Hash(syntax::keywords[i].text, h) == Hash(syntax::keywords[j].text, h))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    constexpr KeywordHash
+    FindKeywordHash()
+    {
+        for(std::size_t first = 1; first < 256; first += 1)
+        {
+            for(std::size_t last = 0; last < 256; last += 1)
+            {
+                const auto h = KeywordHash{first, last};
+                if(IsPerfect(h)) { return h; }
+            }
+        }
+        return {};
+    }
+
+
+    constexpr auto keyword_hash = FindKeywordHash();
+    static_assert(keyword_hash.first != 0, "unable to find a perfect hash for the keywords");
+
+
+    constexpr std::array<syntax::Keyword, keyword_table_size>
+    MakeKeywordTable()
+    {
+        std::array<syntax::Keyword, keyword_table_size> r = {};
+        for(auto& k: r) { k.type = TokenType::Identifier; }
+        for(const auto& k: syntax::keywords)
+        {
+            r[Hash(k.text, keyword_hash)] = k;
+        }
+        return r;
+    }
+
+
+    constexpr auto keyword_table = MakeKeywordTable();
+
+
+    constexpr bool
+    IsValidKeywords()
+    {
+        for(const auto& k: syntax::keywords)
+        {
+            if(k.text.empty() || !Is(k.text[0], char_flags::IdentifierStart)) { return false; }
+            for(const auto c: k.text)
+            {
+                if(!Is(c, char_flags::IdentifierPart)) { return false; }
+            }
+        }
+        return true;
+    }
+
+
+    static_assert(IsValidKeywords(), "keywords must be valid identifiers");
+
+
+    // returns Identifier if the text isn't a keyword
+    constexpr TokenType
+    LookupKeyword(std::string_view s)
+    {
+        if(s.empty()) { return TokenType::Identifier; }
+        const auto& k = keyword_table[Hash(s, keyword_hash)];
+        return k.text == s ? k.type : TokenType::Identifier;
+    }
+
+}
+
+#endif  // FEL_LEXER_TABLES_H
@@ -0,0 +1,83 @@
+#include "fel/lineindex.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "fel/scan.h"
+
+namespace fel
+{
+    LineIndex::LineIndex(std::string_view d)
+        : data(d)
+    {
+    }
+
+
+    const std::vector<std::uint32_t>&
+    LineIndex::GetLineStarts() const
+    {
+        std::call_once(built, [this]()
+        {
+            // a guess to avoid most of the reallocations
+            line_starts.reserve(data.size() / 32 + 1);
+            line_starts.emplace_back(0);
+
+            auto index = scan::FindLineFeed(data, 0);
+            while(index < data.size())
+            {
+                line_starts.emplace_back(static_cast<std::uint32_t>(index + 1));
+                index = scan::FindLineFeed(data, index + 1);
+            }
+        });
+        return line_starts;
+    }
+
+
+    std::size_t
+    LineIndex::GetLineIndex(std::size_t offset) const
+    {
+        const auto& starts = GetLineStarts();
+        const auto found = std::upper_bound(starts.begin(), starts.end(), offset);
+        assert(found != starts.begin());
+        return static_cast<std::size_t>(found - starts.begin()) - 1;
+    }
+
+
+    Location
+    LineIndex::GetLocation(std::size_t offset) const
+    {
+        const auto line = GetLineIndex(offset);
+        const auto column = offset - GetLineStarts()[line];
+        return {static_cast<int>(line + 1), static_cast<int>(column)};
+    }
+
+
+    Location
+    LineIndex::GetUtf16Location(std::size_t offset) const
+    {
+        const auto line = GetLineIndex(offset);
+        const auto start = GetLineStarts()[line];
+
+        int column = 0;
+        const auto end = std::min(offset, data.size());
+        for(auto i = static_cast<std::size_t>(start); i < end; i += 1)
+        {
+            const auto c = static_cast<unsigned char>(data[i]);
+
+            // continuation bytes are part of the previous code point
+            if((c & 0xC0) == 0x80) { continue; }
+
+            // 4 byte sequences are outside the bmp and need a surrogate pair
+            column += (c & 0xF8) == 0xF0 ? 2 : 1;
+        }
+
+        return {static_cast<int>(line + 1), column};
+    }
+
+
+    std::size_t
+    LineIndex::GetLineCount() const
+    {
+        return GetLineStarts().size();
+    }
+}
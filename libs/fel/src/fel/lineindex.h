@@ -0,0 +1,44 @@
+#ifndef FEL_LINEINDEX_H
+#define FEL_LINEINDEX_H
+
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "fel/location.h"
+
+namespace fel
+{
+    // resolves byte offsets to lines and columns, the table of line starts
+    // is built the first time it's needed
+    struct LineIndex
+    {
+        std::string_view data;
+
+        explicit LineIndex(std::string_view d);
+
+        // line is 1 based and column is the 0 based byte index in the line
+        Location
+        GetLocation(std::size_t offset) const;
+
+        // column in utf-16 code units, as used by the language server protocol
+        Location
+        GetUtf16Location(std::size_t offset) const;
+
+        std::size_t
+        GetLineCount() const;
+
+    private:
+        mutable std::once_flag built;
+        mutable std::vector<std::uint32_t> line_starts;
+
+        const std::vector<std::uint32_t>&
+        GetLineStarts() const;
+
+        std::size_t
+        GetLineIndex(std::size_t offset) const;
+    };
+}
+
+#endif  // FEL_LINEINDEX_H
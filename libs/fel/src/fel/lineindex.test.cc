@@ -0,0 +1,54 @@
+#include "catch.hpp"
+
+#include "fel/lineindex.h"
+#include "fel/file.h"
+#include "fel/lexer.h"
+#include "fel/log.h"
+
+using namespace fel;
+
+
+TEST_CASE("lineindex", "[lineindex]")
+{
+    const auto lines = LineIndex{"ab\ncd\r\n\nef"};
+
+    CHECK(lines.GetLineCount() == 4);
+
+    CHECK(lines.GetLocation(0) == Location{1, 0});
+    CHECK(lines.GetLocation(1) == Location{1, 1});
+    CHECK(lines.GetLocation(2) == Location{1, 2});
+    CHECK(lines.GetLocation(3) == Location{2, 0});
+    CHECK(lines.GetLocation(5) == Location{2, 2});
+    CHECK(lines.GetLocation(7) == Location{3, 0});
+    CHECK(lines.GetLocation(8) == Location{4, 0});
+    CHECK(lines.GetLocation(10) == Location{4, 2});
+}
+
+
+TEST_CASE("lineindex-utf16", "[lineindex]")
+{
+    // a (1 byte), o with umlaut (2 bytes), euro sign (3 bytes), emoji (4 bytes)
+    const auto lines = LineIndex{"x\na\xc3\xb6\xe2\x82\xac\xf0\x9f\x98\x80z"};
+
+    CHECK(lines.GetUtf16Location(2) == Location{2, 0});
+    CHECK(lines.GetUtf16Location(3) == Location{2, 1});
+    CHECK(lines.GetUtf16Location(5) == Location{2, 2});
+    CHECK(lines.GetUtf16Location(8) == Location{2, 3});
+    CHECK(lines.GetUtf16Location(12) == Location{2, 5});
+
+    CHECK(lines.GetLocation(12) == Location{2, 10});
+}
+
+
+TEST_CASE("lineindex-tokens", "[lineindex]")
+{
+    Log log;
+    const auto file = File{"source", "a\n  b // c\n/* d\n */ e"};
+    auto reader = LexerReader{file, &log};
+    const auto tokens = GetAllTokensInFile(&reader);
+    REQUIRE(tokens.size() == 3);
+
+    CHECK(tokens[0].GetWhere() == Where{file.id, {1, 0}});
+    CHECK(tokens[1].GetWhere() == Where{file.id, {2, 2}});
+    CHECK(tokens[2].GetWhere() == Where{file.id, {4, 4}});
+}
@@ -91,6 +91,18 @@ namespace fel::log
             assert(entry.arguments.size() == 1);
             o << "Found unknown character '" << Arg(entry, 0) << "'";
             break;
+        case Type::NumberOutOfRange:
+            assert(entry.arguments.size() == 1);
+            o << "Number is out of range: " << Arg(entry, 0);
+            break;
+        case Type::FileTooLarge:
+            assert(entry.arguments.size() == 1);
+            o << "File is too large to lex: " << Arg(entry, 0) << " bytes";
+            break;
+        case Type::ReadError:
+            assert(entry.arguments.size() == 1);
+            o << "Failed to read: " << Arg(entry, 0);
+            break;
         case Type::MissingCloseParen:
             assert(entry.arguments.size() == 0);
             o << "Missing close paren";
@@ -99,6 +111,10 @@ namespace fel::log
             assert(entry.arguments.size() == 0);
             o << "Expected expression";
             break;
+        case Type::ExpressionTooComplex:
+            assert(entry.arguments.size() == 0);
+            o << "Expression is too complex";
+            break;
         case Type::InvalidOperationOnNull:
             assert(entry.arguments.size() == 1);
             o << "Invalid operation on null: " << Arg(entry, 0);
@@ -107,10 +123,34 @@ namespace fel::log
             assert(entry.arguments.size() == 1);
             o << "Invalid binary operation: " << Arg(entry, 0);
             break;
+        case Type::InvalidUnaryOperation:
+            assert(entry.arguments.size() == 1);
+            o << "Invalid unary operation: " << Arg(entry, 0);
+            break;
+        case Type::UndefinedModulo:
+            assert(entry.arguments.size() == 1);
+            o << "Undefined result of " << Arg(entry, 0) << ", the divisor is 0 or the result overflows";
+            break;
         case Type::ThisEvaluatesTo:
             assert(entry.arguments.size() == 2);
             o << "this evaluates to " << Arg(entry, 1) << " (type: " << Arg(entry, 0) << ")";
             break;
+        case Type::ThisHasType:
+            assert(entry.arguments.size() == 1);
+            o << "this has the type " << Arg(entry, 0);
+            break;
+        case Type::UnknownVariable:
+            assert(entry.arguments.size() == 1);
+            o << "Unknown variable: " << Arg(entry, 0);
+            break;
+        case Type::UnsupportedInBatch:
+            assert(entry.arguments.size() == 1);
+            o << "Can't evaluate a " << Arg(entry, 0) << " in a batch";
+            break;
+        case Type::ColumnSizeMismatch:
+            assert(entry.arguments.size() == 1);
+            o << "The column " << Arg(entry, 0) << " isn't the same size as the others";
+            break;
         case Type::InternalError:
             assert(entry.arguments.size() == 1);
             o << "Internal error: " << Arg(entry, 0);
@@ -171,7 +211,7 @@ namespace fel
         const std::vector<std::string>& args
     )
     {
-        AddError(Where{where.file.filename, where.location}, type, args);
+        AddError(Where{where}, type, args);
     }
 
 
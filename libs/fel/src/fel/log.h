@@ -24,12 +24,22 @@ namespace fel
         {
             EosInString,
             UnknownCharacter,
+            NumberOutOfRange, // {0: number}
+            FileTooLarge, // {0: size in bytes}
+            ReadError, // {0: reason}
             MissingCloseParen,
             ExpectedExpression,
+            ExpressionTooComplex, // too deeply nested to compile
 
             InvalidOperationOnNull,
             InvalidBinaryOperation,
+            InvalidUnaryOperation, // {0: operator}
+            UndefinedModulo, // dividing by 0 or overflowing {0: operator}
             ThisEvaluatesTo, // this evalues to {0: type} {0: value}
+            ThisHasType, // {0: type}
+            UnknownVariable, // {0: name}
+            UnsupportedInBatch, // {0: what}
+            ColumnSizeMismatch, // {0: name}
 
             InternalError // unhandled code path {0: reason}
         };
@@ -0,0 +1,268 @@
+#include "fel/parallellexer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "fel/file.h"
+#include "fel/lexer_core.h"
+#include "fel/log.h"
+#include "fel/scan.h"
+#include "fel/threadpool.h"
+
+namespace fel
+{
+    namespace
+    {
+        constexpr std::size_t MinimumChunkSize = 256 * 1024;
+        constexpr std::size_t MaximumChunkSize = 16 * 1024 * 1024;
+
+
+        struct Chunk
+        {
+            // tokens that start in [begin, end) belong to the chunk
+            std::size_t begin = 0;
+            std::size_t end = 0;
+
+            TokenBuffer tokens;
+
+            // where the first token after the chunk starts
+            std::size_t next_start = 0;
+
+            // the end of stream was found in the chunk
+            bool reached_end = false;
+
+            // the first token that the serial lexer would also produce
+            std::size_t first = 0;
+            bool is_used = true;
+
+            // filled when the chunk is copied to the result
+            std::size_t output_index = 0;
+            std::vector<std::size_t> errors;
+        };
+
+
+        // lexes the tokens that start in the chunk, beginning at from
+        void
+        LexChunk(const File& file, std::size_t from, Chunk* chunk)
+        {
+            const auto data = file.data;
+            const bool is_last = chunk->end >= data.size();
+
+            chunk->tokens = TokenBuffer{};
+            chunk->tokens.file = file.id;
+            chunk->tokens.Reserve(chunk->end > from ? chunk->end - from : 0);
+            chunk->reached_end = false;
+
+            auto index = from;
+            while(true)
+            {
+                auto state = lexer_core::SkipState{};
+                const auto start = lexer_core::SkipWhitespace(data, index, &state, true).index;
+                if(start >= chunk->end && !is_last)
+                {
+                    chunk->next_start = start;
+                    return;
+                }
+
+                const auto scanned = lexer_core::ScanToken(data, start);
+                if(scanned.type == TokenType::EndOfStream)
+                {
+                    chunk->next_start = start;
+                    chunk->reached_end = true;
+                    return;
+                }
+
+                chunk->tokens.Add
+                ({
+                    scanned.type,
+                    static_cast<std::uint32_t>(start),
+                    static_cast<std::uint32_t>(scanned.end - start),
+                    file.id,
+                    scanned.flags
+                });
+                index = scanned.end;
+            }
+        }
+
+
+        std::vector<Chunk>
+        SplitIntoChunks(std::string_view data, std::size_t chunk_size)
+        {
+            // split after newlines, it's less likely to be inside a string
+            std::vector<Chunk> chunks;
+            std::size_t begin = 0;
+            while(begin < data.size())
+            {
+                auto end = data.size();
+                if(data.size() - begin > chunk_size)
+                {
+                    end = std::min(data.size(), scan::FindLineFeed(data, begin + chunk_size) + 1);
+                }
+
+                auto& chunk = chunks.emplace_back();
+                chunk.begin = begin;
+                chunk.end = end;
+                begin = end;
+            }
+            return chunks;
+        }
+
+
+        // the serial lexer reaches the chunk at position, returns true if the
+        // guessed tokens can be used from there
+        bool
+        FindFirstToken(Chunk* chunk, std::size_t position)
+        {
+            const auto& offsets = chunk->tokens.offsets;
+            const auto found = std::lower_bound(offsets.begin(), offsets.end(), position);
+            if(found != offsets.end())
+            {
+                chunk->first = static_cast<std::size_t>(found - offsets.begin());
+                return *found == position;
+            }
+
+            chunk->first = offsets.size();
+            return chunk->next_start == position;
+        }
+
+
+        bool
+        IsError(TokenType type, std::uint8_t flags)
+        {
+            if(type == TokenType::Unknown) { return true; }
+            if(flags & token_flags::OutOfRange) { return true; }
+            return type == TokenType::String && (flags & token_flags::Unterminated);
+        }
+
+
+        void
+        MoveChunk(Chunk* chunk, TokenBuffer* result)
+        {
+            auto& tokens = chunk->tokens;
+            const auto first = static_cast<std::ptrdiff_t>(chunk->first);
+            const auto out = static_cast<std::ptrdiff_t>(chunk->output_index);
+
+            std::copy(tokens.types.begin() + first, tokens.types.end(), result->types.begin() + out);
+            std::copy(tokens.flags.begin() + first, tokens.flags.end(), result->flags.begin() + out);
+            std::copy(tokens.offsets.begin() + first, tokens.offsets.end(), result->offsets.begin() + out);
+            std::copy(tokens.lengths.begin() + first, tokens.lengths.end(), result->lengths.begin() + out);
+            std::copy(tokens.literals.begin() + first, tokens.literals.end(), result->literals.begin() + out);
+
+            for(auto index = chunk->first; index < tokens.GetSize(); index += 1)
+            {
+                if(IsError(tokens.types[index], tokens.flags[index]))
+                {
+                    chunk->errors.emplace_back(chunk->output_index + index - chunk->first);
+                }
+            }
+        }
+
+
+        // the same errors as the serial lexer reports
+        void
+        ReportError(const File& file, const TokenBuffer& tokens, std::size_t index, Log* log)
+        {
+            const auto end = tokens.offsets[index] + tokens.lengths[index];
+            const auto where = Where{file.id, GetLocation(file.id, end)};
+            if(tokens.types[index] == TokenType::Unknown)
+            {
+                const auto unknown_character = std::string{1, file.data[tokens.offsets[index]]};
+                log->AddError(where, log::Type::UnknownCharacter, {unknown_character});
+            }
+            else if(tokens.flags[index] & token_flags::OutOfRange)
+            {
+                const auto lexeme = std::string{tokens.GetLexeme(index)};
+                log->AddError(tokens.GetToken(index).GetWhere(), log::Type::NumberOutOfRange, {lexeme});
+            }
+            else
+            {
+                log->AddError(where, log::Type::EosInString, {});
+            }
+        }
+    }
+
+
+    TokenBuffer
+    LexFileParallel(const File& file, Log* log, ThreadPool* pool, std::size_t chunk_size)
+    {
+        if(IsTooLarge(file))
+        {
+            ReportTooLarge(file, log);
+            auto empty = TokenBuffer{};
+            empty.file = file.id;
+            return empty;
+        }
+
+        const auto threads = pool->GetThreadCount();
+        if(chunk_size == 0)
+        {
+            chunk_size = std::clamp(file.data.size() / (threads * 4), MinimumChunkSize, MaximumChunkSize);
+        }
+
+        auto chunks = SplitIntoChunks(file.data, chunk_size);
+        if(threads == 1 || chunks.size() <= 1)
+        {
+            return LexFile(file, log);
+        }
+
+        // guess that every chunk starts outside of strings and comments
+        pool->ForEach(chunks.size(), [&](std::size_t index)
+        {
+            auto& chunk = chunks[index];
+            LexChunk(file, chunk.begin, &chunk);
+        });
+
+        // follow the serial lexer through the chunks and fix the wrong guesses
+        std::size_t token_count = 0;
+        const Chunk* previous = nullptr;
+        for(auto& chunk: chunks)
+        {
+            if(previous != nullptr)
+            {
+                if(previous->reached_end)
+                {
+                    chunk.is_used = false;
+                    continue;
+                }
+
+                if(!FindFirstToken(&chunk, previous->next_start))
+                {
+                    LexChunk(file, previous->next_start, &chunk);
+                    chunk.first = 0;
+                }
+            }
+
+            chunk.output_index = token_count;
+            token_count += chunk.tokens.GetSize() - chunk.first;
+            previous = &chunk;
+        }
+
+        TokenBuffer result;
+        result.file = file.id;
+        result.types.resize(token_count);
+        result.flags.resize(token_count);
+        result.offsets.resize(token_count);
+        result.lengths.resize(token_count);
+        result.literals.resize(token_count);
+
+        pool->ForEach(chunks.size(), [&](std::size_t index)
+        {
+            auto& chunk = chunks[index];
+            if(chunk.is_used)
+            {
+                MoveChunk(&chunk, &result);
+            }
+        });
+
+        for(const auto& chunk: chunks)
+        {
+            for(const auto error: chunk.errors)
+            {
+                ReportError(file, result, error, log);
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef FEL_PARALLELLEXER_H
+#define FEL_PARALLELLEXER_H
+
+#include <cstddef>
+
+#include "fel/tokenbuffer.h"
+
+namespace fel
+{
+    struct File;
+    struct Log;
+    struct ThreadPool;
+
+
+    // lexes the file in chunks on the pool, the tokens and the log are the
+    // same as from LexFile. Each chunk is lexed as if it started outside of
+    // strings and comments, the guesses are then checked in order and a chunk
+    // is lexed again if it was started at the wrong place.
+    // a chunk size of 0 picks one from the file size and the number of threads
+    TokenBuffer
+    LexFileParallel(const File& file, Log* log, ThreadPool* pool, std::size_t chunk_size = 0);
+}
+
+#endif  // FEL_PARALLELLEXER_H
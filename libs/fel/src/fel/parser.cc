@@ -1,133 +1,144 @@
 #include "fel/parser.h"
 
+#include <cassert>
+#include <memory>
+
 #include "fel/lexer.h"
-#include "fel/ast.h"
 #include "fel/log.h"
 
 namespace fel
 {
     Parser::Parser(const File& file, Log* l)
-        : reader(file, l)
+        : lexer(file, l)
         , log(l)
     {
+        tokens.file = file.id;
+        ast.file = file.id;
+        ast.source = std::make_shared<const File>(file);
     }
 
 
-    Expr
+    std::optional<Ast>
     Parser::Parse()
     {
         try
         {
-            return ParseExpression();
+            ast.root = ParseExpression();
+            return std::move(ast);
         }
         catch (const ParseError&)
         {
-            return nullptr;
+            return std::nullopt;
         }
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParseExpression()
     {
         return ParseEquality();
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParseEquality()
     {
-        Expr expr = ParseComparison();
+        auto expr = ParseComparison();
 
         while(ParseMatch({TokenType::NotEqual, TokenType::Equal}))
         {
             auto op = GetPreviousToken();
             auto right = ParseComparison();
-            expr = std::make_shared<BinaryExpression>(expr, op, right);
+            expr = ast.AddBinary(expr, op, right);
         }
 
         return expr;
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParseComparison()
     {
-        Expr expr = ParseTerm();
+        auto expr = ParseTerm();
 
         while(ParseMatch({TokenType::Greater, TokenType::GreaterEqual, TokenType::Less, TokenType::LessEqual}))
         {
             auto op = GetPreviousToken();
             auto right = ParseTerm();
-            expr = std::make_shared<BinaryExpression>(expr, op, right);
+            expr = ast.AddBinary(expr, op, right);
         }
 
         return expr;
     }
 
-    Expr
+    NodeIndex
     Parser::ParseTerm()
     {
-        Expr expr = ParseFactor();
+        auto expr = ParseFactor();
 
         while(ParseMatch({TokenType::Minus, TokenType::Plus}))
         {
             auto op = GetPreviousToken();
             auto right = ParseFactor();
-            expr = std::make_shared<BinaryExpression>(expr, op, right);
+            expr = ast.AddBinary(expr, op, right);
         }
 
         return expr;
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParseFactor()
     {
-        Expr expr = ParseUnary();
+        auto expr = ParseUnary();
 
         while(ParseMatch({TokenType::Div, TokenType::Mult}))
         {
             auto op = GetPreviousToken();
             auto right = ParseUnary();
-            expr = std::make_shared<BinaryExpression>(expr, op, right);
+            expr = ast.AddBinary(expr, op, right);
         }
 
         return expr;
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParseUnary()
     {
         if (ParseMatch({TokenType::Not, TokenType::Minus}))
         {
             auto op = GetPreviousToken();
             auto right = ParseUnary();
-            return std::make_shared<UnaryExpression>(op, right);
+            return ast.AddUnary(op, right);
         }
 
         return ParsePrimary();
     }
 
 
-    Expr
+    NodeIndex
     Parser::ParsePrimary()
     {
-        if(ParseMatch({TokenType::KeywordFalse})) return std::make_shared<LiteralExpression>(Object::FromBool(false), GetPreviousToken().where);
-        if(ParseMatch({TokenType::KeywordTrue})) return std::make_shared<LiteralExpression>(Object::FromBool(true), GetPreviousToken().where);
-        if(ParseMatch({TokenType::KeywordNull})) return std::make_shared<LiteralExpression>(nullptr, GetPreviousToken().where);
+        if(ParseMatch({TokenType::KeywordFalse})) return ast.AddLiteral(Value::FromBool(false), GetPreviousToken());
+        if(ParseMatch({TokenType::KeywordTrue})) return ast.AddLiteral(Value::FromBool(true), GetPreviousToken());
+        if(ParseMatch({TokenType::KeywordNull})) return ast.AddLiteral(Value{}, GetPreviousToken());
 
         if(ParseMatch({TokenType::Int, TokenType::Number, TokenType::String}))
         {
-            return std::make_shared<LiteralExpression>(GetPreviousToken().literal, GetPreviousToken().where);
+            return ast.AddLiteral(tokens.GetLiteral(next_token - 1), GetPreviousToken());
+        }
+
+        if(ParseMatch({TokenType::Identifier}))
+        {
+            return ast.AddVariable(tokens.GetSymbol(next_token - 1), GetPreviousToken());
         }
 
         if(ParseMatch({TokenType::OpenParen}))
         {
             auto expr = ParseExpression();
             Consume(TokenType::CloseParen, log::Type::MissingCloseParen);
-            return std::make_shared<GroupingExpression>(expr);
+            return ast.AddGrouping(expr);
         }
 
 
@@ -159,7 +170,7 @@ namespace fel
     void
     Parser::ReportError(Token token, const log::Type type, const std::vector<std::string>& args)
     {
-        log->AddError(token.where, type, args);
+        log->AddError(token.GetWhere(), type, args);
     }
 
 
@@ -223,26 +234,48 @@ namespace fel
     Token
     Parser::Peek()
     {
-        return reader.Peek();
+        if(next_token < tokens.GetSize())
+        {
+            return tokens.GetToken(next_token);
+        }
+
+        if(!end_of_stream)
+        {
+            const auto token = lexer.GetNextToken();
+            if(token.type != TokenType::EndOfStream)
+            {
+                tokens.Add(token, log);
+                return token;
+            }
+            end_of_stream = token;
+        }
+
+        return *end_of_stream;
     }
 
 
     Token
     Parser::Advance()
     {
-        return reader.Read();
+        const auto token = Peek();
+        if(token.type != TokenType::EndOfStream)
+        {
+            next_token += 1;
+        }
+        return token;
     }
 
     Token
     Parser::GetPreviousToken()
     {
-        return *reader.previous;
+        assert(next_token > 0);
+        return tokens.GetToken(next_token - 1);
     }
 
 
     bool
     Parser::IsAtEnd()
     {
-        return reader.Peek().type == TokenType::EndOfStream;
+        return Peek().type == TokenType::EndOfStream;
     }
 }
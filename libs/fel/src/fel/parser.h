@@ -1,17 +1,18 @@
 #ifndef FEL_PARSER_H
 #define FEL_PARSER_H
 
-#include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 
+#include "fel/ast.h"
 #include "fel/lexer.h"
 #include "fel/log.h"
+#include "fel/tokenbuffer.h"
 
 
 namespace fel
 {
-    struct Expression;
     struct File;
 
 
@@ -20,38 +21,44 @@ namespace fel
     };
 
 
-    using Expr = std::shared_ptr<Expression>;
-
-
     struct Parser
     {
-        LexerReader reader;
+        // tokens are lexed into the buffer as they are needed
+        Lexer lexer;
+        TokenBuffer tokens;
+        std::size_t next_token = 0;
+        std::optional<Token> end_of_stream;
+
+        // the nodes are added to the tree as they are parsed
+        Ast ast;
+
         Log* log;
 
         Parser(const File& file, Log* l);
 
-        Expr
+        // the tree or nothing if there was a error
+        std::optional<Ast>
         Parse();
 
-        Expr
+        NodeIndex
         ParseExpression();
 
-        Expr
+        NodeIndex
         ParseEquality();
 
-        Expr
+        NodeIndex
         ParseComparison();
 
-        Expr
+        NodeIndex
         ParseTerm();
 
-        Expr
+        NodeIndex
         ParseFactor();
 
-        Expr
+        NodeIndex
         ParseUnary();
 
-        Expr
+        NodeIndex
         ParsePrimary();
 
         Token
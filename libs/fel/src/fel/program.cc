@@ -0,0 +1,121 @@
+#include "fel/program.h"
+
+#include <cassert>
+#include <functional>
+
+#include "fel/fold.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+#include "fel/vm.h"
+
+namespace fel
+{
+    Program::Program(File a_file, Ast a_ast)
+        : file(std::move(a_file))
+        , ast(std::move(a_ast))
+    {
+    }
+
+
+    Value
+    Program::Run(Vm* vm) const
+    {
+        if(native) { return native->Run(); }
+        return vm->Run(code);
+    }
+
+
+    std::shared_ptr<const Program>
+    Prepare(const std::string& filename, std::string source, Log* log)
+    {
+        const auto errors = log->entries.size();
+        auto file = File{filename, std::move(source)};
+        auto parser = Parser{file, log};
+        auto ast = parser.Parse();
+        if(!ast || log->entries.size() != errors)
+        {
+            return nullptr;
+        }
+
+        // the work that is the same for every run is done once here
+        auto program = std::make_shared<Program>(std::move(file), FoldConstants(*ast));
+        auto code = Compile(program->ast, log);
+        if(!code)
+        {
+            return nullptr;
+        }
+        program->code = std::move(*code);
+        program->native = CompileNative(program->ast);
+        return program;
+    }
+
+
+    ProgramCache::ProgramCache(std::size_t a_capacity)
+        : capacity(a_capacity)
+    {
+        assert(capacity > 0);
+    }
+
+
+    std::shared_ptr<const Program>
+    ProgramCache::Get(std::string_view source, Log* log)
+    {
+        const auto hash = std::hash<std::string_view>{}(source);
+
+        // two sources with the same hash replace each other
+        const auto is_match = [&](const auto& found)
+        {
+            return found != by_hash.end() && found->second->program->file.data == source;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            const auto found = by_hash.find(hash);
+            if(is_match(found))
+            {
+                entries.splice(entries.begin(), entries, found->second);
+                hits += 1;
+                return found->second->program;
+            }
+            misses += 1;
+        }
+
+        // prepared without the lock so other sources can be looked up while
+        // this is parsed
+        auto program = Prepare("cache", std::string{source}, log);
+        if(program == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex};
+        const auto found = by_hash.find(hash);
+        if(is_match(found))
+        {
+            // another thread prepared it at the same time
+            return found->second->program;
+        }
+        if(found != by_hash.end())
+        {
+            entries.erase(found->second);
+            by_hash.erase(found);
+        }
+
+        entries.push_front(Entry{hash, program});
+        by_hash[hash] = entries.begin();
+        if(entries.size() > capacity)
+        {
+            by_hash.erase(entries.back().hash);
+            entries.pop_back();
+        }
+        return program;
+    }
+
+
+    std::size_t
+    ProgramCache::GetSize() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return entries.size();
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef FEL_PROGRAM_H
+#define FEL_PROGRAM_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "fel/ast.h"
+#include "fel/bytecode.h"
+#include "fel/file.h"
+#include "fel/jit.h"
+#include "fel/value.h"
+
+namespace fel
+{
+    struct Log;
+    struct Vm;
+
+
+    // a expression that is parsed and compiled once and run many times. It's
+    // never changed after it's prepared so it can be run on many threads at
+    // the same time, each with a vm of its own
+    struct Program
+    {
+        Program(File a_file, Ast a_ast);
+
+        // the code points to the ast
+        Program(const Program&) = delete;
+        void operator=(const Program&) = delete;
+
+        // errors are reported to the log of the vm like when running code
+        Value
+        Run(Vm* vm) const;
+
+        // keeps the source alive for the error messages
+        File file;
+        Ast ast;
+
+        // the bytecode is used when there is no native code
+        Code code;
+        std::optional<NativeCode> native;
+    };
+
+
+    // parse and compile the source, returns null and reports to the log if
+    // it fails
+    std::shared_ptr<const Program>
+    Prepare(const std::string& filename, std::string source, Log* log);
+
+
+    // the programs of the recently used sources, when full the least
+    // recently used is removed. Safe to use from multiple threads
+    struct ProgramCache
+    {
+        explicit ProgramCache(std::size_t a_capacity);
+
+        ProgramCache(const ProgramCache&) = delete;
+        void operator=(const ProgramCache&) = delete;
+
+        // the cached program for the source or a newly prepared one. Sources
+        // that fail aren't cached so the errors are reported every time
+        std::shared_ptr<const Program>
+        Get(std::string_view source, Log* log);
+
+        std::size_t
+        GetSize() const;
+
+        struct Entry
+        {
+            std::size_t hash;
+            std::shared_ptr<const Program> program;
+        };
+
+        std::size_t capacity;
+
+        // the most recently used first
+        mutable std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::size_t, std::list<Entry>::iterator> by_hash;
+
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+}
+
+#endif  // FEL_PROGRAM_H
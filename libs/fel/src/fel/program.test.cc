@@ -0,0 +1,127 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fel/log.h"
+#include "fel/program.h"
+#include "fel/threadpool.h"
+#include "fel/vm.h"
+
+using namespace fel;
+
+
+TEST_CASE("program", "[program]")
+{
+    Log log;
+    auto vm = Vm{&log};
+
+    const auto numbers = Prepare("source", "(1 + 2) * 3", &log);
+    REQUIRE(numbers);
+    CHECK(Stringify(numbers->Run(&vm)) == "9");
+    CHECK(Stringify(numbers->Run(&vm)) == "9");
+
+    // strings can't be compiled to native code, they run on the vm
+    const auto strings = Prepare("source", "'a' + 'b'", &log);
+    REQUIRE(strings);
+    CHECK(Stringify(strings->Run(&vm)) == "ab");
+    CHECK(log.IsEmpty());
+
+    // errors when running are reported every time it's run
+    const auto fails = Prepare("source", "1 + 'a'", &log);
+    REQUIRE(fails);
+    CHECK(log.IsEmpty());
+    CHECK(fails->Run(&vm).IsNull());
+    CHECK(log.IsEmpty() == false);
+
+    Log parse_log;
+    CHECK_FALSE(Prepare("source", "1 +", &parse_log));
+    CHECK(parse_log.IsEmpty() == false);
+}
+
+
+TEST_CASE("program-cache", "[program]")
+{
+    Log log;
+    auto cache = ProgramCache{2};
+
+    const auto first = cache.Get("1 + 2", &log);
+    REQUIRE(first);
+    CHECK(cache.Get("1 + 2", &log) == first);
+    CHECK(cache.hits == 1);
+    CHECK(cache.misses == 1);
+
+    // the least recently used is removed when full
+    const auto second = cache.Get("2 + 3", &log);
+    CHECK(cache.Get("1 + 2", &log) == first);
+    CHECK(cache.Get("3 + 4", &log));
+    CHECK(cache.GetSize() == 2);
+    CHECK(cache.Get("1 + 2", &log) == first);
+    CHECK(cache.Get("2 + 3", &log) != second);
+
+    // failures aren't cached
+    CHECK_FALSE(cache.Get("1 +", &log));
+    CHECK(cache.GetSize() == 2);
+}
+
+
+TEST_CASE("program-cache-threads", "[program]")
+{
+    auto pool = ThreadPool{4};
+    auto cache = ProgramCache{8};
+    std::atomic<int> failures {0};
+
+    pool.ForEach(2000, [&](std::size_t index)
+    {
+        const auto n = static_cast<int>(index % 16);
+        Log log;
+        auto vm = Vm{&log};
+        // half of them run as native code and half on the vm
+        const auto is_string = n % 2 == 1;
+        const auto source = is_string ? "'" + std::to_string(n) + "' + 'x'" : std::to_string(n) + " * 2";
+        const auto expected = is_string ? std::to_string(n) + "x" : std::to_string(n * 2);
+        const auto program = cache.Get(source, &log);
+        if(!program || Stringify(program->Run(&vm)) != expected || !log.IsEmpty())
+        {
+            failures += 1;
+        }
+    });
+
+    CHECK(failures == 0);
+    CHECK(cache.GetSize() == 8);
+    CHECK(cache.hits + cache.misses == 2000);
+}
+
+
+TEST_CASE("program-shared-folded-string", "[program]")
+{
+    // long enough for the folded concatenation to be a rope, every thread
+    // reads the same literal the first time it's run
+    const auto half = std::string(40, 'a');
+    Log log;
+    const auto program = Prepare("source", "'" + half + "' + '" + half + "'", &log);
+    REQUIRE(program);
+    REQUIRE(program->ast.nodes.size() == 1);
+
+    std::atomic<bool> start {false};
+    std::atomic<int> failures {0};
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i += 1)
+    {
+        threads.emplace_back([&]
+        {
+            while(start == false) { std::this_thread::yield(); }
+            Log run_log;
+            auto vm = Vm{&run_log};
+            if(Stringify(program->Run(&vm)) != half + half || !run_log.IsEmpty())
+            {
+                failures += 1;
+            }
+        });
+    }
+    start = true;
+    for(auto& thread: threads) { thread.join(); }
+    CHECK(failures == 0);
+}
@@ -0,0 +1,551 @@
+#include "fel/scan.h"
+
+#include <cstdint>
+
+#include "fel/lexer_tables.h"
+#include "fel/syntax.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define FEL_SCAN_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+#if defined(FEL_SCAN_SSE2) && (defined(__GNUC__) || defined(__clang__))
+    #define FEL_SCAN_AVX2 1
+    #include <immintrin.h>
+    #define FEL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace fel::scan
+{
+    namespace
+    {
+        namespace char_flags = lexer_tables::char_flags;
+
+        constexpr char block_begin = syntax::block_comment_begin[0];
+        constexpr char block_end = syntax::block_comment_end[0];
+
+
+        int
+        CountTrailingZeros(std::uint32_t mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanForward(&index, mask);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+
+
+        // --------------------------------------------------------------------
+        // scalar, used on all platforms and for the tail of the simd kernels
+
+        template<typename Predicate>
+        std::size_t
+        ScalarWhile(std::string_view data, std::size_t from, Predicate predicate)
+        {
+            auto i = from;
+            while(i < data.size() && predicate(data[i]))
+            {
+                i += 1;
+            }
+            return i;
+        }
+
+
+        std::size_t
+        ScalarSkipWhitespace(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return lexer_tables::Is(c, char_flags::Whitespace); });
+        }
+
+
+        std::size_t
+        ScalarFindNewline(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return c != 0 && !lexer_tables::Is(c, char_flags::Newline); });
+        }
+
+
+        std::size_t
+        ScalarFindLineFeed(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return c != '\n'; });
+        }
+
+
+        std::size_t
+        ScalarFindBlockCommentMarker(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return c != 0 && c != block_begin && c != block_end; });
+        }
+
+
+        std::size_t
+        ScalarSkipIdentifier(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return lexer_tables::Is(c, char_flags::IdentifierPart); });
+        }
+
+
+        std::size_t
+        ScalarSkipDigits(std::string_view data, std::size_t from)
+        {
+            return ScalarWhile(data, from, [](char c) { return lexer_tables::Is(c, char_flags::Digit); });
+        }
+
+
+        // --------------------------------------------------------------------
+        // sse2, 16 bytes at a time, always available on x86-64
+
+#ifdef FEL_SCAN_SSE2
+        __m128i
+        Sse2Eq(__m128i chunk, char c)
+        {
+            return _mm_cmpeq_epi8(chunk, _mm_set1_epi8(c));
+        }
+
+
+        // c in [lo, hi], only valid for ascii ranges
+        __m128i
+        Sse2InRange(__m128i chunk, char lo, char hi)
+        {
+            const auto above = _mm_cmpgt_epi8(chunk, _mm_set1_epi8(static_cast<char>(lo - 1)));
+            const auto below = _mm_cmplt_epi8(chunk, _mm_set1_epi8(static_cast<char>(hi + 1)));
+            return _mm_and_si128(above, below);
+        }
+
+
+        // match returns the matching bytes, stop_on_match tells if the scan
+        // stops at the first match or at the first mismatch
+        template<typename Match, typename Scalar>
+        std::size_t
+        Sse2Scan(std::string_view data, std::size_t from, bool stop_on_match, Match match, Scalar scalar)
+        {
+            const auto* p = data.data();
+            auto i = from;
+            while(i + 16 <= data.size())
+            {
+                const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(match(chunk)));
+                if(!stop_on_match) { mask = ~mask & 0xFFFFu; }
+                if(mask != 0)
+                {
+                    return i + static_cast<std::size_t>(CountTrailingZeros(mask));
+                }
+                i += 16;
+            }
+            return scalar(data, i);
+        }
+
+
+        std::size_t
+        Sse2SkipWhitespace(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, false, [](__m128i c)
+            {
+                return _mm_or_si128
+                (
+                    _mm_or_si128(Sse2Eq(c, ' '), Sse2Eq(c, '\t')),
+                    _mm_or_si128(Sse2Eq(c, '\r'), Sse2Eq(c, '\n'))
+                );
+            }, ScalarSkipWhitespace);
+        }
+
+
+        std::size_t
+        Sse2FindNewline(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, true, [](__m128i c)
+            {
+                return _mm_or_si128
+                (
+                    _mm_or_si128(Sse2Eq(c, '\r'), Sse2Eq(c, '\n')),
+                    Sse2Eq(c, 0)
+                );
+            }, ScalarFindNewline);
+        }
+
+
+        std::size_t
+        Sse2FindLineFeed(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, true, [](__m128i c)
+            {
+                return Sse2Eq(c, '\n');
+            }, ScalarFindLineFeed);
+        }
+
+
+        std::size_t
+        Sse2FindBlockCommentMarker(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, true, [](__m128i c)
+            {
+                return _mm_or_si128
+                (
+                    _mm_or_si128(Sse2Eq(c, block_begin), Sse2Eq(c, block_end)),
+                    Sse2Eq(c, 0)
+                );
+            }, ScalarFindBlockCommentMarker);
+        }
+
+
+        std::size_t
+        Sse2SkipIdentifier(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, false, [](__m128i c)
+            {
+                const auto lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+                return _mm_or_si128
+                (
+                    _mm_or_si128(Sse2InRange(lower, 'a', 'z'), Sse2InRange(c, '0', '9')),
+                    Sse2Eq(c, '_')
+                );
+            }, ScalarSkipIdentifier);
+        }
+
+
+        std::size_t
+        Sse2SkipDigits(std::string_view data, std::size_t from)
+        {
+            return Sse2Scan(data, from, false, [](__m128i c)
+            {
+                return Sse2InRange(c, '0', '9');
+            }, ScalarSkipDigits);
+        }
+#endif
+
+
+        // --------------------------------------------------------------------
+        // avx2, 32 bytes at a time, selected at runtime
+
+#ifdef FEL_SCAN_AVX2
+        // lambdas don't inherit the target attribute, so the matchers are
+        // structs with a static function instead
+
+        FEL_TARGET_AVX2 inline __m256i
+        Avx2Eq(__m256i chunk, char c)
+        {
+            return _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c));
+        }
+
+
+        FEL_TARGET_AVX2 inline __m256i
+        Avx2InRange(__m256i chunk, char lo, char hi)
+        {
+            const auto above = _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8(static_cast<char>(lo - 1)));
+            const auto below = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), chunk);
+            return _mm256_and_si256(above, below);
+        }
+
+
+        template<typename Match>
+        FEL_TARGET_AVX2 std::size_t
+        Avx2Scan(std::string_view data, std::size_t from)
+        {
+            const auto* p = data.data();
+            auto i = from;
+            while(i + 32 <= data.size())
+            {
+                const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(Match::Get(chunk)));
+                if(!Match::stop_on_match) { mask = ~mask; }
+                if(mask != 0)
+                {
+                    return i + static_cast<std::size_t>(CountTrailingZeros(mask));
+                }
+                i += 32;
+            }
+            return Match::Scalar(data, i);
+        }
+
+
+        struct Avx2Whitespace
+        {
+            static constexpr bool stop_on_match = false;
+            static constexpr auto Scalar = ScalarSkipWhitespace;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                return _mm256_or_si256
+                (
+                    _mm256_or_si256(Avx2Eq(c, ' '), Avx2Eq(c, '\t')),
+                    _mm256_or_si256(Avx2Eq(c, '\r'), Avx2Eq(c, '\n'))
+                );
+            }
+        };
+
+
+        struct Avx2Newline
+        {
+            static constexpr bool stop_on_match = true;
+            static constexpr auto Scalar = ScalarFindNewline;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                return _mm256_or_si256
+                (
+                    _mm256_or_si256(Avx2Eq(c, '\r'), Avx2Eq(c, '\n')),
+                    Avx2Eq(c, 0)
+                );
+            }
+        };
+
+
+        struct Avx2LineFeed
+        {
+            static constexpr bool stop_on_match = true;
+            static constexpr auto Scalar = ScalarFindLineFeed;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                return Avx2Eq(c, '\n');
+            }
+        };
+
+
+        struct Avx2BlockCommentMarker
+        {
+            static constexpr bool stop_on_match = true;
+            static constexpr auto Scalar = ScalarFindBlockCommentMarker;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                return _mm256_or_si256
+                (
+                    _mm256_or_si256(Avx2Eq(c, block_begin), Avx2Eq(c, block_end)),
+                    Avx2Eq(c, 0)
+                );
+            }
+        };
+
+
+        struct Avx2Identifier
+        {
+            static constexpr bool stop_on_match = false;
+            static constexpr auto Scalar = ScalarSkipIdentifier;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                const auto lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+                return _mm256_or_si256
+                (
+                    _mm256_or_si256(Avx2InRange(lower, 'a', 'z'), Avx2InRange(c, '0', '9')),
+                    Avx2Eq(c, '_')
+                );
+            }
+        };
+
+
+        struct Avx2Digits
+        {
+            static constexpr bool stop_on_match = false;
+            static constexpr auto Scalar = ScalarSkipDigits;
+
+            FEL_TARGET_AVX2 static __m256i
+            Get(__m256i c)
+            {
+                return Avx2InRange(c, '0', '9');
+            }
+        };
+#endif
+
+
+        // --------------------------------------------------------------------
+        // dispatch
+
+        using ScanFunction = std::size_t (*)(std::string_view, std::size_t);
+
+        struct Kernels
+        {
+            ScanFunction skip_whitespace;
+            ScanFunction find_newline;
+            ScanFunction find_line_feed;
+            ScanFunction find_block_comment_marker;
+            ScanFunction skip_identifier;
+            ScanFunction skip_digits;
+        };
+
+
+        constexpr Kernels scalar_kernels =
+        {
+            ScalarSkipWhitespace,
+            ScalarFindNewline,
+            ScalarFindLineFeed,
+            ScalarFindBlockCommentMarker,
+            ScalarSkipIdentifier,
+            ScalarSkipDigits
+        };
+
+
+#ifdef FEL_SCAN_SSE2
+        constexpr Kernels sse2_kernels =
+        {
+            Sse2SkipWhitespace,
+            Sse2FindNewline,
+            Sse2FindLineFeed,
+            Sse2FindBlockCommentMarker,
+            Sse2SkipIdentifier,
+            Sse2SkipDigits
+        };
+#endif
+
+
+#ifdef FEL_SCAN_AVX2
+        constexpr Kernels avx2_kernels =
+        {
+            Avx2Scan<Avx2Whitespace>,
+            Avx2Scan<Avx2Newline>,
+            Avx2Scan<Avx2LineFeed>,
+            Avx2Scan<Avx2BlockCommentMarker>,
+            Avx2Scan<Avx2Identifier>,
+            Avx2Scan<Avx2Digits>
+        };
+#endif
+
+
+        const Kernels&
+        GetKernels(Kernel kernel)
+        {
+            switch(kernel)
+            {
+#ifdef FEL_SCAN_AVX2
+            case Kernel::Avx2: return avx2_kernels;
+#endif
+#ifdef FEL_SCAN_SSE2
+            case Kernel::Sse2: return sse2_kernels;
+#endif
+            default: return scalar_kernels;
+            }
+        }
+
+
+        const Kernels&
+        GetBestKernels()
+        {
+            static const Kernels& best = GetKernels(GetBestKernel());
+            return best;
+        }
+    }
+
+
+    Kernel
+    GetBestKernel()
+    {
+        return GetSupportedKernels().back();
+    }
+
+
+    std::vector<Kernel>
+    GetSupportedKernels()
+    {
+        std::vector<Kernel> kernels = {Kernel::Scalar};
+#ifdef FEL_SCAN_SSE2
+        kernels.emplace_back(Kernel::Sse2);
+#endif
+#ifdef FEL_SCAN_AVX2
+        if(__builtin_cpu_supports("avx2"))
+        {
+            kernels.emplace_back(Kernel::Avx2);
+        }
+#endif
+        return kernels;
+    }
+
+
+    std::size_t
+    SkipWhitespace(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().skip_whitespace(data, from);
+    }
+
+
+    std::size_t
+    FindNewline(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().find_newline(data, from);
+    }
+
+
+    std::size_t
+    FindLineFeed(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().find_line_feed(data, from);
+    }
+
+
+    std::size_t
+    FindBlockCommentMarker(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().find_block_comment_marker(data, from);
+    }
+
+
+    std::size_t
+    SkipIdentifier(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().skip_identifier(data, from);
+    }
+
+
+    std::size_t
+    SkipDigits(std::string_view data, std::size_t from)
+    {
+        return GetBestKernels().skip_digits(data, from);
+    }
+
+
+    std::size_t
+    SkipWhitespace(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).skip_whitespace(data, from);
+    }
+
+
+    std::size_t
+    FindNewline(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).find_newline(data, from);
+    }
+
+
+    std::size_t
+    FindLineFeed(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).find_line_feed(data, from);
+    }
+
+
+    std::size_t
+    FindBlockCommentMarker(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).find_block_comment_marker(data, from);
+    }
+
+
+    std::size_t
+    SkipIdentifier(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).skip_identifier(data, from);
+    }
+
+
+    std::size_t
+    SkipDigits(Kernel kernel, std::string_view data, std::size_t from)
+    {
+        return GetKernels(kernel).skip_digits(data, from);
+    }
+}
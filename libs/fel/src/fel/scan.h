@@ -0,0 +1,70 @@
+#ifndef FEL_SCAN_H
+#define FEL_SCAN_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Scanning kernels for the lexer. All functions take a index to start at
+// and return the index of the first byte that didn't match, or the size of
+// the data if everything matched.
+
+namespace fel::scan
+{
+    enum class Kernel
+    {
+        Scalar, Sse2, Avx2
+    };
+
+
+    // the best kernel for the cpu we are running on
+    Kernel
+    GetBestKernel();
+
+
+    // all kernels that can run on this cpu, mostly useful for testing
+    std::vector<Kernel>
+    GetSupportedKernels();
+
+
+    // skips space, tab, \r and \n
+    std::size_t
+    SkipWhitespace(std::string_view data, std::size_t from);
+
+
+    // finds the next \r, \n or \0
+    std::size_t
+    FindNewline(std::string_view data, std::size_t from);
+
+
+    // finds the next \n
+    std::size_t
+    FindLineFeed(std::string_view data, std::size_t from);
+
+
+    // finds the next first character of the block comment begin or end
+    // marker or a \0, the caller needs to check the second character
+    std::size_t
+    FindBlockCommentMarker(std::string_view data, std::size_t from);
+
+
+    // skips a-z, A-Z, 0-9 and _
+    std::size_t
+    SkipIdentifier(std::string_view data, std::size_t from);
+
+
+    // skips 0-9
+    std::size_t
+    SkipDigits(std::string_view data, std::size_t from);
+
+
+    // the same functions as above but with a specific kernel
+    std::size_t SkipWhitespace(Kernel kernel, std::string_view data, std::size_t from);
+    std::size_t FindNewline(Kernel kernel, std::string_view data, std::size_t from);
+    std::size_t FindLineFeed(Kernel kernel, std::string_view data, std::size_t from);
+    std::size_t FindBlockCommentMarker(Kernel kernel, std::string_view data, std::size_t from);
+    std::size_t SkipIdentifier(Kernel kernel, std::string_view data, std::size_t from);
+    std::size_t SkipDigits(Kernel kernel, std::string_view data, std::size_t from);
+}
+
+#endif  // FEL_SCAN_H
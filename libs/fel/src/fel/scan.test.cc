@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <string>
+#include <random>
+
+#include "fel/scan.h"
+
+using namespace fel;
+
+
+namespace
+{
+    std::string
+    RandomSource(std::size_t size, unsigned int seed)
+    {
+        using namespace std::string_literals;
+        const auto alphabet = "  \t\r\n\nabcXYZ_019/**/\"'.+-\0\x80\xff"s;
+        auto rng = std::mt19937{seed};
+        auto dist = std::uniform_int_distribution<std::size_t>{0, alphabet.size() - 1};
+        std::string r;
+        for(std::size_t i=0; i<size; i+=1)
+        {
+            // long runs of the same class to exercise the vector loops
+            const auto c = alphabet[dist(rng)];
+            const auto run = dist(rng) % 3 == 0 ? dist(rng) * 2 : 1;
+            r.append(run, c);
+        }
+        return r;
+    }
+}
+
+
+TEST_CASE("scan-kernels", "[scan]")
+{
+    const auto source = RandomSource(2000, 42);
+    const auto data = std::string_view{source};
+
+    for(const auto kernel: scan::GetSupportedKernels())
+    {
+        INFO("kernel " << static_cast<int>(kernel));
+        for(std::size_t i=0; i<=data.size(); i+=1)
+        {
+            REQUIRE(scan::SkipWhitespace(kernel, data, i) == scan::SkipWhitespace(scan::Kernel::Scalar, data, i));
+            REQUIRE(scan::FindNewline(kernel, data, i) == scan::FindNewline(scan::Kernel::Scalar, data, i));
+            REQUIRE(scan::FindLineFeed(kernel, data, i) == scan::FindLineFeed(scan::Kernel::Scalar, data, i));
+            REQUIRE(scan::FindBlockCommentMarker(kernel, data, i) == scan::FindBlockCommentMarker(scan::Kernel::Scalar, data, i));
+            REQUIRE(scan::SkipIdentifier(kernel, data, i) == scan::SkipIdentifier(scan::Kernel::Scalar, data, i));
+            REQUIRE(scan::SkipDigits(kernel, data, i) == scan::SkipDigits(scan::Kernel::Scalar, data, i));
+        }
+    }
+}
+
+
+TEST_CASE("scan-scalar", "[scan]")
+{
+    const auto k = scan::Kernel::Scalar;
+    CHECK(scan::SkipWhitespace(k, "  \t\r\n x", 0) == 6);
+    CHECK(scan::FindNewline(k, "// abc\r\n", 0) == 6);
+    CHECK(scan::FindBlockCommentMarker(k, "abc */", 0) == 4);
+    CHECK(scan::SkipIdentifier(k, "abc_Z09+", 0) == 7);
+    CHECK(scan::SkipDigits(k, "0123.5", 0) == 4);
+    CHECK(scan::SkipDigits(k, "0123", 0) == 4);
+}
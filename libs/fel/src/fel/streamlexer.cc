@@ -0,0 +1,209 @@
+#include "fel/streamlexer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <istream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "fel/log.h"
+#include "fel/scan.h"
+
+namespace fel
+{
+    std::string_view
+    StreamToken::GetLexeme() const
+    {
+        return lexer_core::GetLexeme(type, flags, text);
+    }
+
+
+    ChunkReader
+    ReadFromStream(std::istream& stream)
+    {
+        return [&stream](char* destination, std::size_t size, std::string* error) -> std::size_t
+        {
+            stream.read(destination, static_cast<std::streamsize>(size));
+
+            // the end of the stream only sets eof and fail
+            if(stream.bad())
+            {
+                *error = "the stream is bad";
+                return 0;
+            }
+            return static_cast<std::size_t>(stream.gcount());
+        };
+    }
+
+
+    ChunkReader
+    ReadFromDescriptor(int fd)
+    {
+        return [fd](char* destination, std::size_t size, std::string* error) -> std::size_t
+        {
+            while(true)
+            {
+#ifdef _WIN32
+                const auto read = _read(fd, destination, static_cast<unsigned int>(size));
+#else
+                const auto read = ::read(fd, destination, size);
+#endif
+                if(read >= 0)
+                {
+                    return static_cast<std::size_t>(read);
+                }
+                if(errno != EINTR)
+                {
+                    *error = std::generic_category().message(errno);
+                    return 0;
+                }
+            }
+        };
+    }
+
+
+    StreamLexer::StreamLexer
+    (
+        const std::string& filename,
+        ChunkReader a_reader,
+        Log* a_log,
+        std::size_t a_chunk_size
+    )
+        : file(InternFileName(filename))
+        , reader(std::move(a_reader))
+        , log(a_log)
+        , chunk_size(std::max<std::size_t>(a_chunk_size, 1))
+    {
+    }
+
+
+    void
+    StreamLexer::Refill()
+    {
+        // count the lines in what is about to be dropped
+        GetLocation(index);
+
+        buffer.erase(0, index);
+        buffer_offset += index;
+        tracked_index -= index;
+        index = 0;
+
+        // a token that doesn't fit is scanned again from the start, reading
+        // at least as much as is kept makes that linear instead of quadratic
+        const auto kept = buffer.size();
+        const auto to_read = std::max(chunk_size, kept);
+        buffer.resize(kept + to_read);
+        std::size_t read = 0;
+        while(read < to_read)
+        {
+            std::string error;
+            const auto r = reader(buffer.data() + kept + read, to_read - read, &error);
+            if(!error.empty())
+            {
+                buffer.resize(kept + read);
+                // the buffered tokens are still to be lexed
+                log->AddError(Where{file, PeekLocation(buffer.size())}, log::Type::ReadError, {error});
+            }
+            if(r == 0)
+            {
+                is_complete = true;
+                break;
+            }
+            read += r;
+
+            // don't wait for a full chunk when there is something to lex
+            if(read >= to_read / 2) { break; }
+        }
+        buffer.resize(kept + read);
+    }
+
+
+    Location
+    StreamLexer::GetLocation(std::size_t buffer_index)
+    {
+        CountLines(buffer_index, &line, &line_start);
+        tracked_index = std::max(tracked_index, buffer_index);
+
+        const auto column = buffer_offset + buffer_index - line_start;
+        return {line, static_cast<int>(column)};
+    }
+
+
+    Location
+    StreamLexer::PeekLocation(std::size_t buffer_index) const
+    {
+        auto peeked_line = line;
+        auto peeked_line_start = line_start;
+        CountLines(buffer_index, &peeked_line, &peeked_line_start);
+
+        const auto column = buffer_offset + buffer_index - peeked_line_start;
+        return {peeked_line, static_cast<int>(column)};
+    }
+
+
+    void
+    StreamLexer::CountLines(std::size_t buffer_index, int* counted_line, std::uint64_t* counted_line_start) const
+    {
+        const auto data = std::string_view{buffer}.substr(0, buffer_index);
+        auto newline = scan::FindLineFeed(data, std::min(tracked_index, buffer_index));
+        while(newline < data.size())
+        {
+            *counted_line += 1;
+            *counted_line_start = buffer_offset + newline + 1;
+            newline = scan::FindLineFeed(data, newline + 1);
+        }
+    }
+
+
+    StreamToken
+    StreamLexer::GetNextToken()
+    {
+        while(true)
+        {
+            const auto skipped = lexer_core::SkipWhitespace(buffer, index, &skip_state, is_complete);
+            index = skipped.index;
+            if(!skipped.needs_more) { break; }
+            Refill();
+        }
+
+        auto scanned = lexer_core::ScanToken(buffer, index);
+        while(scanned.end >= buffer.size() && !is_complete)
+        {
+            // the token might continue in the next chunk
+            Refill();
+            scanned = lexer_core::ScanToken(buffer, index);
+        }
+
+        const auto start = index;
+        index = scanned.end;
+
+        auto token = StreamToken{};
+        token.type = scanned.type;
+        token.flags = scanned.flags;
+        token.offset = buffer_offset + start;
+        token.location = GetLocation(start);
+        token.text = std::string_view{buffer}.substr(start, scanned.end - start);
+
+        switch(scanned.error)
+        {
+        case lexer_core::ScanError::UnknownCharacter:
+            {
+                const auto unknown_character = std::string{1, buffer[start]};
+                log->AddError(Where{file, GetLocation(scanned.end)}, log::Type::UnknownCharacter, {unknown_character});
+            }
+            break;
+        case lexer_core::ScanError::EosInString:
+            log->AddError(Where{file, GetLocation(scanned.end)}, log::Type::EosInString, {});
+            break;
+        case lexer_core::ScanError::None:
+            break;
+        }
+
+        return token;
+    }
+}
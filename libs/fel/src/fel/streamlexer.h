@@ -0,0 +1,114 @@
+#ifndef FEL_STREAMLEXER_H
+#define FEL_STREAMLEXER_H
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+#include "fel/filetable.h"
+#include "fel/lexer_core.h"
+#include "fel/location.h"
+#include "fel/tokentype.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    // a token from the stream lexer, the text is a view into the lexer buffer
+    // and is only valid until the next token is requested
+    struct StreamToken
+    {
+        TokenType type = TokenType::EndOfStream;
+        std::uint8_t flags = 0;
+        std::uint64_t offset = 0;
+        Location location;
+        std::string_view text;
+
+        // the source text of the token, strings are returned without quotes
+        std::string_view
+        GetLexeme() const;
+    };
+
+
+    // reads at most size bytes to destination and returns the number of bytes
+    // read, 0 means there is no more data. If reading failed the reason is
+    // set in error and 0 is returned
+    using ChunkReader = std::function<std::size_t (char* destination, std::size_t size, std::string* error)>;
+
+
+    ChunkReader
+    ReadFromStream(std::istream& stream);
+
+
+    ChunkReader
+    ReadFromDescriptor(int fd);
+
+
+    // lexes the data as it is read, only the unread part of the last chunk
+    // and the token being lexed are kept in memory. Comments of any size are
+    // skipped without being stored, only a single huge token grows the buffer.
+    // A read error is reported and handled like the end of the stream
+    struct StreamLexer
+    {
+        static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+        StreamLexer
+        (
+            const std::string& filename,
+            ChunkReader a_reader,
+            Log* a_log,
+            std::size_t a_chunk_size = DefaultChunkSize
+        );
+
+        // returns EndOfStream when all data has been lexed
+        StreamToken
+        GetNextToken();
+
+        FileId file;
+        ChunkReader reader;
+        Log* log;
+        std::size_t chunk_size;
+
+    private:
+        std::string buffer;
+
+        // the next byte to lex in the buffer
+        std::size_t index = 0;
+
+        // stream offset of the first byte in the buffer
+        std::uint64_t buffer_offset = 0;
+
+        // the reader has no more data
+        bool is_complete = false;
+
+        lexer_core::SkipState skip_state;
+
+        // lines are counted incrementally, tracked_index is the first byte
+        // in the buffer that hasn't been counted
+        std::size_t tracked_index = 0;
+        int line = 1;
+        std::uint64_t line_start = 0;
+
+        // drops everything before index and reads a new chunk
+        void
+        Refill();
+
+        // the location of a byte in the buffer, the lines before it are
+        // counted and not counted again
+        Location
+        GetLocation(std::size_t buffer_index);
+
+        // like GetLocation but without counting the lines, for locations
+        // ahead of the tokens that haven't been lexed yet
+        Location
+        PeekLocation(std::size_t buffer_index) const;
+
+        void
+        CountLines(std::size_t buffer_index, int* counted_line, std::uint64_t* counted_line_start) const;
+    };
+}
+
+#endif  // FEL_STREAMLEXER_H
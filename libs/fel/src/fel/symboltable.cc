@@ -0,0 +1,125 @@
+#include "fel/symboltable.h"
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace fel
+{
+    namespace
+    {
+        // the table is split in shards with a lock each so lexing on
+        // multiple threads doesn't fight over a single lock
+        constexpr std::size_t ShardBits = 6;
+        constexpr std::size_t ShardCount = std::size_t{1} << ShardBits;
+
+
+        // open addressing with linear probing, the hash is cached in the
+        // symbol so it's only compared with the text when the hashes match
+        struct Shard
+        {
+            std::mutex mutex;
+            std::deque<StringObject> storage;
+            std::vector<StringObject*> slots = std::vector<StringObject*>(64, nullptr);
+
+            StringObject**
+            FindSlot(std::size_t hash, std::string_view text)
+            {
+                const auto mask = slots.size() - 1;
+                auto index = (hash >> ShardBits) & mask;
+                while(slots[index] != nullptr)
+                {
+                    const auto* symbol = slots[index];
+                    if(symbol->hash == hash && symbol->s == text)
+                    {
+                        break;
+                    }
+                    index = (index + 1) & mask;
+                }
+                return &slots[index];
+            }
+
+            void
+            Grow()
+            {
+                auto old = std::move(slots);
+                slots = std::vector<StringObject*>(old.size() * 2, nullptr);
+                for(auto* symbol: old)
+                {
+                    if(symbol != nullptr)
+                    {
+                        *FindSlot(symbol->hash, symbol->s) = symbol;
+                    }
+                }
+            }
+        };
+
+
+        std::array<Shard, ShardCount>&
+        GetShards()
+        {
+            static std::array<Shard, ShardCount> shards;
+            return shards;
+        }
+
+
+        Symbol
+        InternInShard(std::size_t hash, std::string_view text)
+        {
+            auto& shard = GetShards()[hash & (ShardCount - 1)];
+
+            std::lock_guard<std::mutex> lock{shard.mutex};
+            auto** slot = shard.FindSlot(hash, text);
+            if(*slot != nullptr)
+            {
+                return *slot;
+            }
+
+            // keep the load below a half
+            if((shard.storage.size() + 1) * 2 > shard.slots.size())
+            {
+                shard.Grow();
+                slot = shard.FindSlot(hash, text);
+            }
+
+            auto& symbol = shard.storage.emplace_back(std::string{text});
+            symbol.is_interned = true;
+            symbol.hash = hash;
+            *slot = &symbol;
+            return &symbol;
+        }
+    }
+
+
+    Symbol
+    Intern(std::string_view text)
+    {
+        const auto hash = std::hash<std::string_view>{}(text);
+
+        // scripts repeat the same few names over and over so a small cache
+        // per thread skips the lock for most lookups
+        constexpr std::size_t CacheSize = 256;
+        thread_local std::array<Symbol, CacheSize> cache = {};
+        auto& cached = cache[(hash >> ShardBits) & (CacheSize - 1)];
+        if(cached == nullptr || cached->hash != hash || cached->s != text)
+        {
+            cached = InternInShard(hash, text);
+        }
+        return cached;
+    }
+
+
+    std::size_t
+    GetSymbolCount()
+    {
+        std::size_t count = 0;
+        for(auto& shard: GetShards())
+        {
+            std::lock_guard<std::mutex> lock{shard.mutex};
+            count += shard.storage.size();
+        }
+        return count;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef FEL_SYMBOLTABLE_H
+#define FEL_SYMBOLTABLE_H
+
+#include <cstddef>
+#include <string_view>
+
+#include "fel/value.h"
+
+namespace fel
+{
+    // a interned string. There is only one symbol for each text so two
+    // symbols are equal if the pointers are equal
+    using Symbol = const StringObject*;
+
+
+    // get the symbol for the text, the process wide table is safe to use from
+    // multiple threads and symbols are never freed so the table grows with
+    // every distinct text. Only intern names and short literals
+    Symbol
+    Intern(std::string_view text);
+
+
+    std::size_t
+    GetSymbolCount();
+}
+
+#endif  // FEL_SYMBOLTABLE_H
@@ -0,0 +1,84 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "fel/file.h"
+#include "fel/lexer.h"
+#include "fel/log.h"
+#include "fel/symboltable.h"
+#include "fel/tokenbuffer.h"
+
+using namespace fel;
+
+
+TEST_CASE("symboltable", "[symboltable]")
+{
+    const auto dog = Intern("dog");
+    CHECK(dog->s == "dog");
+    CHECK(dog->is_interned);
+    CHECK(Intern(std::string{"do"} + "g") == dog);
+    CHECK(Intern("cat") != dog);
+    CHECK(Intern("") == Intern(""));
+
+    // enough to make the shards grow
+    std::vector<Symbol> symbols;
+    for(int i=0; i<5000; i+=1)
+    {
+        symbols.emplace_back(Intern("symbol" + std::to_string(i)));
+    }
+    for(int i=0; i<5000; i+=1)
+    {
+        CHECK(Intern("symbol" + std::to_string(i)) == symbols[static_cast<std::size_t>(i)]);
+    }
+    CHECK(GetSymbolCount() >= 5003);
+}
+
+
+TEST_CASE("symboltable-value", "[symboltable]")
+{
+    const auto a = Value::FromSymbol(Intern("hello"));
+    const auto b = Value::FromSymbol(Intern("hello"));
+    CHECK(a.AsString().data() == b.AsString().data());
+    CHECK(IsSameString(a, b));
+    CHECK_FALSE(IsSameString(a, Value::FromSymbol(Intern("world"))));
+
+    // a string that isn't interned is compared by content
+    CHECK(IsSameString(a, Value::FromString("hello")));
+    CHECK_FALSE(IsSameString(a, Value::FromString("hell")));
+}
+
+
+TEST_CASE("symboltable-tokenbuffer", "[symboltable]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"name 'name' \"na\\me\" 'key' key name"}};
+    const auto tokens = LexFile(file, &log);
+    CHECK(log.IsEmpty());
+
+    REQUIRE(tokens.GetSize() == 6);
+    const auto symbol = [&](std::size_t index) { return tokens.GetLiteral(index).AsString().data(); };
+    CHECK(tokens.GetSymbol(0) == Intern("name"));
+    CHECK(symbol(1) == tokens.GetSymbol(0)->data);
+    CHECK(symbol(2) == tokens.GetSymbol(0)->data);
+    CHECK(symbol(3) == tokens.GetSymbol(4)->data);
+    CHECK(tokens.GetSymbol(5) == tokens.GetSymbol(0));
+}
+
+
+TEST_CASE("symboltable-long-literals", "[symboltable]")
+{
+    // long string literals aren't interned so lexing new text doesn't grow
+    // the table forever
+    const auto text = std::string(MaxInternedLiteral + 1, 'x') + "-unique-to-this-test";
+    const auto file = File{"source", "'" + text + "'"};
+    Log log;
+    const auto tokens = LexFile(file, &log);
+    REQUIRE(tokens.GetSize() == 1);
+
+    const auto before = GetSymbolCount();
+    const auto literal = tokens.GetLiteral(0);
+    CHECK(literal.AsString() == text);
+    CHECK(GetSymbolCount() == before);
+    CHECK(IsSameString(literal, tokens.GetLiteral(0)));
+}
@@ -0,0 +1,91 @@
+#ifndef FEL_SYNTAX_H
+#define FEL_SYNTAX_H
+
+#include <string_view>
+
+#include "fel/tokentype.h"
+
+// The syntax of the language. Don't like {}? Switch them out here before
+// building, the lexer tables are generated from this at compile time so a
+// custom syntax doesn't cost anything at runtime.
+
+namespace fel::syntax
+{
+    struct Keyword
+    {
+        std::string_view text;
+        TokenType type;
+    };
+
+
+    constexpr Keyword keywords[] =
+    {
+        {"if", TokenType::KeywordIf},
+        {"else", TokenType::KeywordElse},
+        {"for", TokenType::KeywordFor},
+        {"fun", TokenType::KeywordFunction},
+        {"return", TokenType::KeywordReturn},
+        {"while", TokenType::KeywordWhile},
+        {"print", TokenType::KeywordPrint},
+        {"var", TokenType::KeywordVar},
+        {"true", TokenType::KeywordTrue},
+        {"false", TokenType::KeywordFalse},
+        {"null", TokenType::KeywordNull}
+    };
+
+
+    // one or two character operators, the two character version is optional
+    struct Punctuation
+    {
+        std::string_view text;
+        TokenType type;
+    };
+
+
+    constexpr Punctuation punctuation[] =
+    {
+        {"{", TokenType::BeginBrace},
+        {"}", TokenType::EndBrace},
+        {"(", TokenType::OpenParen},
+        {")", TokenType::CloseParen},
+        {"[", TokenType::OpenBracket},
+        {"]", TokenType::CloseBracket},
+        {"+", TokenType::Plus},
+        {"-", TokenType::Minus},
+        {"*", TokenType::Mult},
+        {"/", TokenType::Div},
+        {"%", TokenType::Mod},
+        {",", TokenType::Comma},
+        {":", TokenType::Colon},
+        {";", TokenType::Term},
+
+        {".", TokenType::Dot},
+        {"..", TokenType::DotDot},
+        {"=", TokenType::Assign},
+        {"==", TokenType::Equal},
+        {"<", TokenType::Less},
+        {"<=", TokenType::LessEqual},
+        {">", TokenType::Greater},
+        {">=", TokenType::GreaterEqual},
+
+        {"!", TokenType::Not},
+        {"!=", TokenType::NotEqual},
+        {"~", TokenType::BitNot},
+        {"&", TokenType::BitAnd},
+        {"&&", TokenType::And},
+        {"|", TokenType::BitOr},
+        {"||", TokenType::Or}
+    };
+
+
+    // comment markers must be two characters
+    constexpr std::string_view line_comment = "//";
+    constexpr std::string_view block_comment_begin = "/*";
+    constexpr std::string_view block_comment_end = "*/";
+
+    constexpr std::string_view quotes = "\"'";
+    constexpr char escape = '\\';
+    constexpr char decimal_point = '.';
+}
+
+#endif  // FEL_SYNTAX_H
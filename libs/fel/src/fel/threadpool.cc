@@ -0,0 +1,186 @@
+#include "fel/threadpool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace fel
+{
+    namespace
+    {
+        // set for the workers so tasks they queue go to their own queue
+        thread_local const ThreadPool* current_pool = nullptr;
+        thread_local std::size_t current_queue = 0;
+    }
+
+
+    ThreadPool::ThreadPool(std::size_t thread_count)
+    {
+        if(thread_count == 0)
+        {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // the calling thread is one of the threads and uses the shared queue
+        for(std::size_t i = 0; i < thread_count; i += 1)
+        {
+            queues.emplace_back(std::make_unique<Queue>());
+        }
+        for(std::size_t i = 0; i + 1 < thread_count; i += 1)
+        {
+            threads.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{sleep_mutex};
+            stopping = true;
+        }
+        changed.notify_all();
+        for(auto& thread: threads)
+        {
+            thread.join();
+        }
+    }
+
+
+    std::size_t
+    ThreadPool::GetThreadCount() const
+    {
+        return threads.size() + 1;
+    }
+
+
+    void
+    ThreadPool::ForEach(std::size_t count, const std::function<void (std::size_t)>& task)
+    {
+        if(count == 0) { return; }
+
+        std::atomic<std::size_t> remaining {count};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        const auto own = GetOwnQueue();
+        const bool is_worker = own + 1 < queues.size();
+        for(std::size_t index = 0; index < count; index += 1)
+        {
+            // a worker keeps the tasks and lets the idle threads steal them,
+            // the other threads spread them out so no one needs to steal
+            const auto queue = is_worker ? own : next_queue.fetch_add(1) % queues.size();
+            Push(queue, [&, index]()
+            {
+                try
+                {
+                    task(index);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock{error_mutex};
+                    if(!error) { error = std::current_exception(); }
+                }
+
+                // nothing on the stack of ForEach can be used after this
+                if(remaining.fetch_sub(1) == 1)
+                {
+                    Notify();
+                }
+            });
+        }
+        Notify();
+
+        while(remaining > 0)
+        {
+            if(RunOne(own)) { continue; }
+
+            std::unique_lock<std::mutex> lock{sleep_mutex};
+            changed.wait(lock, [&]() { return remaining == 0 || queued_tasks > 0; });
+        }
+
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+
+    void
+    ThreadPool::WorkerLoop(std::size_t own)
+    {
+        current_pool = this;
+        current_queue = own;
+
+        while(true)
+        {
+            if(RunOne(own)) { continue; }
+
+            std::unique_lock<std::mutex> lock{sleep_mutex};
+            changed.wait(lock, [this]() { return stopping || queued_tasks > 0; });
+            if(stopping && queued_tasks == 0) { return; }
+        }
+    }
+
+
+    std::size_t
+    ThreadPool::GetOwnQueue() const
+    {
+        return current_pool == this ? current_queue : queues.size() - 1;
+    }
+
+
+    void
+    ThreadPool::Push(std::size_t queue, std::function<void ()> task)
+    {
+        auto& q = *queues[queue];
+        std::lock_guard<std::mutex> lock{q.mutex};
+        q.tasks.emplace_back(std::move(task));
+        queued_tasks += 1;
+    }
+
+
+    bool
+    ThreadPool::RunOne(std::size_t own)
+    {
+        std::function<void ()> task;
+
+        // newest from the own queue, it's most likely to still be in the cache
+        {
+            auto& q = *queues[own];
+            std::lock_guard<std::mutex> lock{q.mutex};
+            if(!q.tasks.empty())
+            {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+        }
+
+        // oldest from someone else, it's most likely to be a big one
+        for(std::size_t offset = 1; !task && offset < queues.size(); offset += 1)
+        {
+            auto& q = *queues[(own + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock{q.mutex};
+            if(!q.tasks.empty())
+            {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+
+        if(!task) { return false; }
+
+        queued_tasks -= 1;
+        task();
+        return true;
+    }
+
+
+    void
+    ThreadPool::Notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock{sleep_mutex};
+        }
+        changed.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef FEL_THREADPOOL_H
+#define FEL_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fel
+{
+    // a fixed number of worker threads with a queue each. Workers take the
+    // newest task from their own queue and steal the oldest task from the
+    // others when it's empty. The thread waiting for work helps out so it's
+    // safe to wait for more work from inside a task
+    struct ThreadPool
+    {
+        // 0 means one thread per core, the count includes the calling thread
+        explicit ThreadPool(std::size_t thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        void operator=(const ThreadPool&) = delete;
+
+        std::size_t
+        GetThreadCount() const;
+
+        // calls task with 0 to count-1 on the pool and returns when all are
+        // done, the first exception thrown by a task is rethrown here
+        void
+        ForEach(std::size_t count, const std::function<void (std::size_t)>& task);
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void ()>> tasks;
+        };
+
+        // one per worker, the last is shared by the threads outside the pool
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        // sleeping threads wait for tasks to be queued or for work to finish
+        std::mutex sleep_mutex;
+        std::condition_variable changed;
+        std::atomic<std::size_t> queued_tasks {0};
+        std::atomic<std::size_t> next_queue {0};
+        bool stopping = false;
+
+        void
+        WorkerLoop(std::size_t own);
+
+        // the queue of the current thread
+        std::size_t
+        GetOwnQueue() const;
+
+        void
+        Push(std::size_t queue, std::function<void ()> task);
+
+        // runs a task from the own queue or steals one, false if there was none
+        bool
+        RunOne(std::size_t own);
+
+        void
+        Notify();
+    };
+}
+
+#endif  // FEL_THREADPOOL_H
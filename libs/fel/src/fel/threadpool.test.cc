@@ -0,0 +1,61 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "fel/threadpool.h"
+
+using namespace fel;
+
+
+TEST_CASE("threadpool", "[threadpool]")
+{
+    auto pool = ThreadPool{4};
+    CHECK(pool.GetThreadCount() == 4);
+
+    std::vector<int> values(1000, 0);
+    pool.ForEach(values.size(), [&](std::size_t index)
+    {
+        values[index] = static_cast<int>(index) * 2;
+    });
+    for(std::size_t index = 0; index < values.size(); index += 1)
+    {
+        CHECK(values[index] == static_cast<int>(index) * 2);
+    }
+}
+
+
+TEST_CASE("threadpool-nested", "[threadpool]")
+{
+    // waiting inside a task must not deadlock, even with a single thread
+    for(const std::size_t threads: std::vector<std::size_t>{1, 2, 8})
+    {
+        auto pool = ThreadPool{threads};
+        std::atomic<int> count = 0;
+        pool.ForEach(16, [&](std::size_t)
+        {
+            pool.ForEach(16, [&](std::size_t) { count += 1; });
+        });
+        CHECK(count == 16 * 16);
+    }
+}
+
+
+TEST_CASE("threadpool-exception", "[threadpool]")
+{
+    auto pool = ThreadPool{3};
+    std::atomic<int> count = 0;
+    CHECK_THROWS_AS
+    (
+        pool.ForEach(100, [&](std::size_t index)
+        {
+            count += 1;
+            if(index == 42) { throw std::runtime_error{"42"}; }
+        }),
+        std::runtime_error
+    );
+
+    // all tasks are run even if one throws
+    CHECK(count == 100);
+}
@@ -0,0 +1,158 @@
+#include "fel/tokenbuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "fel/file.h"
+#include "fel/log.h"
+
+namespace fel
+{
+    namespace
+    {
+        void
+        ReportOutOfRange(const Token& token, Log* log)
+        {
+            if(log != nullptr)
+            {
+                log->AddError(token.GetWhere(), log::Type::NumberOutOfRange, {std::string{token.GetLexeme()}});
+            }
+        }
+
+
+        // the bits stored in the literal column, false if the number doesn't fit
+        bool
+        DecodeLiteral(const Token& token, std::uint32_t* bits)
+        {
+            *bits = 0;
+            switch(token.type)
+            {
+            case TokenType::Int:
+                {
+                    int value = 0;
+                    if(!DecodeInt(token.GetLexeme(), &value)) { return false; }
+                    *bits = static_cast<std::uint32_t>(value);
+                    return true;
+                }
+            case TokenType::Number:
+                {
+                    float value = 0;
+                    if(!DecodeNumber(token.GetLexeme(), &value)) { return false; }
+                    static_assert(sizeof(value) == sizeof(*bits));
+                    std::memcpy(bits, &value, sizeof(value));
+                    return true;
+                }
+            default:
+                return true;
+            }
+        }
+    }
+
+
+    void
+    TokenBuffer::Reserve(std::size_t file_size)
+    {
+        // a token and the whitespace around it is usually more than 5 bytes
+        const auto count = file_size / 5 + 1;
+        types.reserve(count);
+        flags.reserve(count);
+        offsets.reserve(count);
+        lengths.reserve(count);
+        literals.reserve(count);
+    }
+
+
+    void
+    TokenBuffer::Add(const Token& token, Log* log)
+    {
+        assert(types.empty() || token.file == file);
+        file = token.file;
+
+        std::uint32_t bits = 0;
+        auto added_flags = token.flags;
+        if(!DecodeLiteral(token, &bits))
+        {
+            added_flags |= token_flags::OutOfRange;
+            ReportOutOfRange(token, log);
+        }
+
+        types.emplace_back(token.type);
+        flags.emplace_back(added_flags);
+        offsets.emplace_back(token.offset);
+        lengths.emplace_back(token.length);
+        literals.emplace_back(bits);
+    }
+
+
+    std::size_t
+    TokenBuffer::GetSize() const
+    {
+        return types.size();
+    }
+
+
+    Token
+    TokenBuffer::GetToken(std::size_t index) const
+    {
+        return {types[index], offsets[index], lengths[index], file, flags[index]};
+    }
+
+
+    std::string_view
+    TokenBuffer::GetLexeme(std::size_t index) const
+    {
+        return GetToken(index).GetLexeme();
+    }
+
+
+    Value
+    TokenBuffer::GetLiteral(std::size_t index) const
+    {
+        switch(types[index])
+        {
+        case TokenType::Int:
+            return Value::FromInt(static_cast<int>(literals[index]));
+        case TokenType::Number:
+            {
+                float value = 0;
+                std::memcpy(&value, &literals[index], sizeof(value));
+                return Value::FromFloat(value);
+            }
+        default:
+            return fel::GetLiteral(GetToken(index));
+        }
+    }
+
+
+    Symbol
+    TokenBuffer::GetSymbol(std::size_t index) const
+    {
+        assert(types[index] == TokenType::Identifier);
+        return Intern(GetLexeme(index));
+    }
+
+
+    std::size_t
+    TokenBuffer::Count(TokenType type) const
+    {
+        return static_cast<std::size_t>(std::count(types.begin(), types.end(), type));
+    }
+
+
+    TokenBuffer
+    LexFile(const File& file, Log* log)
+    {
+        TokenBuffer tokens;
+        tokens.file = file.id;
+        tokens.Reserve(file.data.size());
+
+        auto lexer = Lexer{file, log};
+        for(auto token = lexer.GetNextToken(); token.type != TokenType::EndOfStream; token = lexer.GetNextToken())
+        {
+            tokens.Add(token, log);
+        }
+
+        return tokens;
+    }
+}
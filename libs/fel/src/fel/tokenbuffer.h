@@ -0,0 +1,73 @@
+#ifndef FEL_TOKENBUFFER_H
+#define FEL_TOKENBUFFER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fel/filetable.h"
+#include "fel/lexer.h"
+#include "fel/symboltable.h"
+#include "fel/tokentype.h"
+#include "fel/value.h"
+
+namespace fel
+{
+    struct File;
+    struct Log;
+
+
+    // stores the tokens of a file as columns instead of a array of Token,
+    // scanning a single column touches far less memory. Numbers are decoded
+    // once when added, strings and identifiers are read from the file when
+    // they are requested
+    struct TokenBuffer
+    {
+        FileId file = UndefinedFile;
+
+        std::vector<TokenType> types;
+        std::vector<std::uint8_t> flags;
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::uint32_t> lengths;
+
+        // the unboxed bits of a int or number token, 0 for other tokens
+        std::vector<std::uint32_t> literals;
+
+        // reserve room for a guessed number of tokens in a file of the size
+        void
+        Reserve(std::size_t file_size);
+
+        // a number that doesn't fit is stored as 0 and reported to the log
+        void
+        Add(const Token& token, Log* log = nullptr);
+
+        std::size_t
+        GetSize() const;
+
+        Token
+        GetToken(std::size_t index) const;
+
+        std::string_view
+        GetLexeme(std::size_t index) const;
+
+        // the literal as a value, null if the token isn't a literal
+        Value
+        GetLiteral(std::size_t index) const;
+
+        // the interned name of a identifier
+        Symbol
+        GetSymbol(std::size_t index) const;
+
+        std::size_t
+        Count(TokenType type) const;
+    };
+
+
+    // lex the whole file, the end of stream token is not included
+    TokenBuffer
+    LexFile(const File& file, Log* log);
+}
+
+#endif  // FEL_TOKENBUFFER_H
@@ -0,0 +1,68 @@
+#include "fel/tokentype.h"
+
+namespace fel
+{
+    std::string ToString(const TokenType tt)
+    {
+        switch(tt)
+        {
+            #define X(x) case TokenType::x: return #x
+
+            X(Unknown);
+            X(BeginBrace);
+            X(EndBrace);
+            X(OpenParen);
+            X(CloseParen);
+            X(OpenBracket);
+            X(CloseBracket);
+            
+            X(Plus);
+            X(Minus);
+            X(Mult);
+            X(Div);
+            X(Comma);
+            X(Colon);
+            X(Term);
+
+            X(Dot);
+            X(DotDot);
+            X(Equal);
+            X(Assign);
+            X(Less);
+            X(LessEqual);
+            X(Greater);
+            X(GreaterEqual);
+
+
+            X(Not);
+            X(BitNot);
+            X(And);
+            X(Or);
+            X(BitAnd);
+            X(BitOr);
+
+            X(String);
+
+            X(Identifier);
+
+            X(KeywordIf);
+            X(KeywordElse);
+            X(KeywordFor);
+            X(KeywordFunction);
+            X(KeywordVar);
+            X(KeywordTrue);
+            X(KeywordFalse);
+            X(KeywordNull);
+            X(KeywordReturn);
+
+            X(Int);
+            X(Number);
+            
+            X(EndOfStream);
+
+            #undef X
+        default:
+            return "<unknown>";
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef FEL_TOKENTYPE_H
+#define FEL_TOKENTYPE_H
+
+#include <cstdint>
+#include <string>
+
+namespace fel
+{
+    enum class TokenType : std::uint8_t
+    {
+        Unknown,
+        BeginBrace, EndBrace, // {}
+        OpenParen, CloseParen, // ()
+        OpenBracket, CloseBracket, // []
+        
+        Plus, Minus, Mult, Div, Mod, Comma, Colon,
+        Term, // ;
+
+        Dot, DotDot,
+        Equal, Assign,
+        Less, LessEqual,
+        Greater, GreaterEqual,
+
+        Not, NotEqual,
+        And, Or, BitNot, BitAnd, BitOr,
+
+        String,
+
+        Identifier,
+
+        KeywordIf, KeywordElse, KeywordFor, KeywordFunction, KeywordVar,
+        KeywordTrue, KeywordFalse, KeywordNull, KeywordReturn,
+        KeywordWhile,
+
+        // todo(Gustav): remove this when functions work
+        KeywordPrint,
+
+        Int, Number,
+        
+        EndOfStream
+    };
+
+
+    std::string
+    ToString(const TokenType tt);
+}
+
+#endif  // FEL_TOKENTYPE_H
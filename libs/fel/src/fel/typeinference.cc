@@ -0,0 +1,116 @@
+#include "fel/typeinference.h"
+
+#include <string>
+
+#include "fel/interpreter.h"
+#include "fel/log.h"
+
+namespace fel
+{
+    namespace
+    {
+        bool
+        IsKnown(StaticType type)
+        {
+            return type != StaticType::Unknown;
+        }
+
+
+        // a literal is reported like it is when it's run, for the rest
+        // only the type is known
+        void
+        AddOperandError(const Ast& ast, NodeIndex index, Log* log)
+        {
+            auto value_index = index;
+            while(ast.GetNode(value_index).type == NodeType::Grouping)
+            {
+                value_index = ast.GetNode(value_index).right;
+            }
+
+            if(ast.GetNode(value_index).type == NodeType::Literal)
+            {
+                const auto& value = ast.GetLiteral(value_index);
+                log->AddError(ast.GetWhere(index), log::Type::ThisEvaluatesTo, {ToString(value.GetType()), Stringify(value)});
+            }
+            else
+            {
+                const auto type = static_cast<ValueType>(ast.types[index]);
+                log->AddError(ast.GetWhere(index), log::Type::ThisHasType, {ToString(type)});
+            }
+        }
+    }
+
+
+    bool
+    InferTypes(Ast* ast, Log* log, const VariableTypes& variables)
+    {
+        auto& types = ast->types;
+        types.assign(ast->nodes.size(), StaticType::Unknown);
+        auto& can_fail = ast->can_fail;
+        can_fail.assign(ast->nodes.size(), false);
+        bool ok = true;
+
+        // children are before their parents so the types of the operands
+        // are known when a operator is reached
+        for(NodeIndex index = 0; index < ast->nodes.size(); index += 1)
+        {
+            const auto& node = ast->GetNode(index);
+            switch(node.type)
+            {
+            case NodeType::Literal:
+                types[index] = static_cast<StaticType>(ast->GetLiteral(index).GetType());
+                break;
+            case NodeType::Grouping:
+                types[index] = types[node.right];
+                break;
+            case NodeType::Variable:
+                for(const auto& [name, type]: variables)
+                {
+                    if(name == ast->GetVariable(index)) { types[index] = type; }
+                }
+                break;
+            case NodeType::Unary:
+                types[index] = GetUnaryOperationType(node.op, types[node.right]);
+                if(IsKnown(types[node.right]) && !IsKnown(types[index]))
+                {
+                    const auto op = ast->GetToken(index);
+                    log->AddError(op.GetWhere(), log::Type::InvalidUnaryOperation, {std::string{op.GetLexeme()}});
+                    AddOperandError(*ast, node.right, log);
+                    ok = false;
+                }
+                break;
+            case NodeType::Binary:
+                {
+                    const auto lhs = types[node.left];
+                    const auto rhs = types[node.right];
+                    types[index] = GetBinaryOperationType(node.op, lhs, rhs);
+                    if(IsKnown(lhs) && IsKnown(rhs) && !IsKnown(types[index]))
+                    {
+                        // the same errors as when it's run
+                        const auto on_null = lhs == StaticType::Null || rhs == StaticType::Null;
+                        const auto op = ast->GetToken(index);
+                        log->AddError
+                        (
+                            op.GetWhere(),
+                            on_null ? log::Type::InvalidOperationOnNull : log::Type::InvalidBinaryOperation,
+                            {std::string{op.GetLexeme()}}
+                        );
+                        AddOperandError(*ast, node.left, log);
+                        AddOperandError(*ast, node.right, log);
+                        ok = false;
+                    }
+                }
+                break;
+            }
+
+            can_fail[index] = !IsKnown(types[index]) || (node.type == NodeType::Binary && node.op == TokenType::Mod);
+            if(node.type == NodeType::Binary) { can_fail[index] = can_fail[index] || can_fail[node.left]; }
+            if(node.type != NodeType::Literal && node.type != NodeType::Variable)
+            {
+                can_fail[index] = can_fail[index] || can_fail[node.right];
+            }
+        }
+
+        return ok;
+    }
+}
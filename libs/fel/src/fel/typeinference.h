@@ -0,0 +1,26 @@
+#ifndef FEL_TYPEINFERENCE_H
+#define FEL_TYPEINFERENCE_H
+
+#include <utility>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/symboltable.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    // the type of each variable that is known
+    using VariableTypes = std::vector<std::pair<Symbol, StaticType>>;
+
+
+    // set the type of each node in the ast from the literals, the variables
+    // and the operators. Operations that are certain to fail when run are
+    // reported to the log, returns false if there were any
+    bool
+    InferTypes(Ast* ast, Log* log, const VariableTypes& variables = {});
+}
+
+#endif  // FEL_TYPEINFERENCE_H
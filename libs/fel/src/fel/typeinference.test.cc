@@ -0,0 +1,87 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "fel/ast.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+#include "fel/typeinference.h"
+
+using namespace fel;
+
+
+TEST_CASE("typeinference", "[typeinference]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"(1 + 2) * 3 < 2.5 == !null"}};
+    auto parser = Parser{file, &log};
+    auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    CHECK(InferTypes(&*ast, &log));
+    CHECK(log.IsEmpty());
+    REQUIRE(ast->types.size() == ast->nodes.size());
+    CHECK(ast->types[ast->root] == StaticType::Bool);
+
+    const auto& root = ast->GetNode(ast->root);
+    const auto& less = ast->GetNode(root.left);
+    CHECK(ast->types[less.left] == StaticType::Int);
+    CHECK(ast->types[less.right] == StaticType::Number);
+}
+
+
+TEST_CASE("typeinference-errors", "[typeinference]")
+{
+    Log log;
+    const auto file = File{"source", std::string{"(1 + 2) + 'a'"}};
+    auto parser = Parser{file, &log};
+    auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    CHECK_FALSE(InferTypes(&*ast, &log));
+    REQUIRE(log.entries.size() == 3);
+    CHECK(log.entries[0].type == log::Type::InvalidBinaryOperation);
+    CHECK(log.entries[1].type == log::Type::ThisHasType);
+    CHECK(log.entries[1].arguments == std::vector<std::string>{"int"});
+
+    // a literal is reported like it is when it's run
+    CHECK(log.entries[2].type == log::Type::ThisEvaluatesTo);
+    CHECK(log.entries[2].arguments == std::vector<std::string>{"string", "a"});
+    CHECK(ast->types[ast->root] == StaticType::Unknown);
+}
+
+
+TEST_CASE("typeinference-run", "[typeinference]")
+{
+    // the unboxed paths should give the same result as running without types
+    const std::vector<std::string> sources =
+    {
+        "1 + 2 * 3", "-(4 - 2) * 3", "7 / 2", "1.5 * 2 + 1", "1 < 2", "2.5 >= 2",
+        "3 == 3", "3 != 4", "true == !false", "null == null", "null != 1", "!null", "!0",
+        "'a' + 'b' == 'ab'", "!(1 + 'a')", "-(2.5 / 2)"
+    };
+
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+
+        Log log;
+        auto parser = Parser{file, &log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+
+        Log expected_log;
+        const auto expected = Interpreter{&expected_log}.Evaluate(*ast);
+
+        Log typed_log;
+        InferTypes(&*ast, &typed_log);
+        const auto result = Interpreter{&typed_log}.Evaluate(*ast);
+
+        CHECK(result.GetType() == expected.GetType());
+        CHECK(Stringify(result) == Stringify(expected));
+    }
+}
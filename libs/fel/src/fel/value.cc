@@ -0,0 +1,288 @@
+#include "fel/value.h"
+
+#include <charconv>
+#include <cstdio>
+#include <new>
+#include <vector>
+
+#include "fel/arena.h"
+
+
+namespace fel
+{
+    namespace
+    {
+        // shorter concatenations are copied, it's cheaper than a rope node
+        constexpr std::size_t MinimumRopeLength = 64;
+    }
+
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "small strings expect the tag to be stored in the first byte of the value"
+#endif
+
+
+    StringObject::StringObject(std::string ss)
+        : length(ss.size())
+        , s(std::move(ss))
+    {
+        data = s.data();
+    }
+
+
+    StringObject::StringObject(Value l, Value r, std::size_t len, Arena* a)
+        : arena(a)
+        , left(std::move(l))
+        , right(std::move(r))
+        , length(len)
+    {
+    }
+
+
+    StringObject::StringObject(const char* d, std::size_t len, Arena* a)
+        : arena(a)
+        , length(len)
+        , data(d)
+    {
+    }
+
+
+    void
+    StringObject::Flatten()
+    {
+        char* result = nullptr;
+        if(arena != nullptr)
+        {
+            result = static_cast<char*>(arena->Allocate(length, 1));
+        }
+        else
+        {
+            s.resize(length);
+            result = s.data();
+        }
+
+        // a loop instead of recursion since a long chain of concatenations
+        // is a very deep tree
+        std::size_t written = 0;
+        std::vector<const Value*> pieces {&right, &left};
+        while(!pieces.empty())
+        {
+            const auto* piece = pieces.back();
+            pieces.pop_back();
+
+            if(piece->IsHeapString() && piece->GetStringObject()->IsRope())
+            {
+                const auto* object = piece->GetStringObject();
+                pieces.emplace_back(&object->right);
+                pieces.emplace_back(&object->left);
+            }
+            else
+            {
+                const auto text = piece->AsString();
+                std::memcpy(result + written, text.data(), text.size());
+                written += text.size();
+            }
+        }
+
+        assert(written == length);
+        data = result;
+        left = Value{};
+        right = Value{};
+    }
+
+
+    static_assert(alignof(StringObject) > value_detail::TagMask, "the tag is stored in the low bits of the pointer");
+
+
+    Value
+    Value::FromString(std::string str)
+    {
+        if(str.size() <= value_detail::SmallStringCapacity)
+        {
+            return FromSmallString(str);
+        }
+
+        return FromStringObject(new StringObject{std::move(str)});
+    }
+
+
+    Value
+    Value::FromSmallString(std::string_view str)
+    {
+        assert(str.size() <= value_detail::SmallStringCapacity);
+        auto small = value_detail::SmallStringTag | (str.size() << value_detail::SmallStringLengthShift);
+        std::memcpy(reinterpret_cast<char*>(&small) + 1, str.data(), str.size());
+        return Value{small};
+    }
+
+
+    Value
+    Value::Concat(const Value& lhs, const Value& rhs, Arena* arena)
+    {
+        const auto length = lhs.GetStringLength() + rhs.GetStringLength();
+
+        if(arena == nullptr)
+        {
+            if(length < MinimumRopeLength)
+            {
+                auto str = std::string{lhs.AsString()};
+                str += rhs.AsString();
+                return FromString(std::move(str));
+            }
+
+            return FromStringObject(new StringObject{lhs, rhs, length});
+        }
+
+        if(length <= value_detail::SmallStringCapacity)
+        {
+            char text[value_detail::SmallStringCapacity];
+            const auto left = lhs.AsString();
+            const auto right = rhs.AsString();
+            std::memcpy(text, left.data(), left.size());
+            std::memcpy(text + left.size(), right.data(), right.size());
+            return FromSmallString({text, length});
+        }
+
+        auto* memory = arena->Allocate(sizeof(StringObject), alignof(StringObject));
+
+        // arena strings may only point to strings that aren't counted since
+        // nothing in the arena is released on its own
+        const auto is_counted = [](const Value& v) { return v.IsHeapString() && v.GetStringObject()->IsCounted(); };
+        if(length >= MinimumRopeLength && !is_counted(lhs) && !is_counted(rhs))
+        {
+            return FromStringObject(new (memory) StringObject{lhs, rhs, length, arena});
+        }
+
+        auto* text = static_cast<char*>(arena->Allocate(length, 1));
+        const auto left = lhs.AsString();
+        const auto right = rhs.AsString();
+        std::memcpy(text, left.data(), left.size());
+        std::memcpy(text + left.size(), right.data(), right.size());
+        return FromStringObject(new (memory) StringObject{text, length, arena});
+    }
+
+
+    Value
+    Value::CopyOutOfArena(const Value& value)
+    {
+        if(value.IsHeapString() && value.GetStringObject()->arena != nullptr)
+        {
+            return FromString(std::string{value.AsString()});
+        }
+        return value;
+    }
+
+
+    std::size_t
+    Value::GetStringLength() const
+    {
+        if(IsHeapString()) { return GetStringObject()->length; }
+        return AsString().size();
+    }
+
+
+    void
+    Value::Destroy(StringObject* object)
+    {
+        // like Flatten a deep rope is released with a loop
+        std::vector<StringObject*> dead {object};
+        while(!dead.empty())
+        {
+            auto* current = dead.back();
+            dead.pop_back();
+
+            for(auto* child: {&current->left, &current->right})
+            {
+                if(child->IsHeapString() && child->GetStringObject()->IsCounted())
+                {
+                    auto* child_object = child->GetStringObject();
+                    if(child_object->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        dead.emplace_back(child_object);
+                    }
+                }
+                child->bits = value_detail::Tag(ValueType::Null);
+            }
+
+            delete current;
+        }
+    }
+
+
+    std::string
+    Stringify(const Value& value)
+    {
+        char buffer[FormatBufferSize];
+        return std::string{Format(value, buffer)};
+    }
+
+
+    std::string_view
+    Format(const Value& value, char (&buffer)[FormatBufferSize])
+    {
+        switch(value.GetType())
+        {
+        case ValueType::Null:
+            return "null";
+        case ValueType::Bool:
+            if(value.AsBool()) { return "true";  }
+            else               { return "false"; }
+        case ValueType::Int:
+            {
+                const auto result = std::to_chars(buffer, buffer + FormatBufferSize, value.AsInt());
+                assert(result.ec == std::errc{});
+                return {buffer, static_cast<std::size_t>(result.ptr - buffer)};
+            }
+        case ValueType::Number:
+            {
+                // the same as the default of a ostream, 6 digits in fixed or scientific
+#if defined(__cpp_lib_to_chars)
+                const auto result = std::to_chars(buffer, buffer + FormatBufferSize, value.AsNumber(), std::chars_format::general, 6);
+                assert(result.ec == std::errc{});
+                return {buffer, static_cast<std::size_t>(result.ptr - buffer)};
+#else
+                // the float to_chars is missing before gcc 11 and in older libc++
+                const auto written = std::snprintf(buffer, FormatBufferSize, "%g", static_cast<double>(value.AsNumber()));
+                assert(written > 0 && static_cast<std::size_t>(written) < FormatBufferSize);
+                return {buffer, static_cast<std::size_t>(written)};
+#endif
+            }
+        case ValueType::String:
+            return value.AsString();
+        default:
+            assert(false && "unhandled case");
+            return "<internal_error>";
+        }
+    }
+
+
+    bool
+    IsSameString(const Value& lhs, const Value& rhs)
+    {
+        assert(lhs.GetType() == ValueType::String && rhs.GetType() == ValueType::String);
+        if(lhs.bits == rhs.bits) { return true; }
+
+        const auto both_interned = lhs.IsHeapString() && lhs.GetStringObject()->is_interned
+            && rhs.IsHeapString() && rhs.GetStringObject()->is_interned;
+        if(both_interned) { return false; }
+
+        return lhs.AsString() == rhs.AsString();
+    }
+
+
+    std::string
+    ToString(ValueType type)
+    {
+        switch(type)
+        {
+            case ValueType::Null: return "null";
+            case ValueType::Bool: return "bool";
+            case ValueType::Int: return "int";
+            case ValueType::Number: return "number";
+            case ValueType::String: return "string";
+            default:
+                assert(false && "unhandled case");
+                return "<internal_error>";
+        }
+    }
+}
@@ -0,0 +1,422 @@
+#ifndef FEL_VALUE_H
+#define FEL_VALUE_H
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+
+namespace fel
+{
+    struct Arena;
+
+
+    enum class ValueType : std::uint8_t
+    {
+        Null, Bool, Int, Number, String
+    };
+
+
+    struct StringObject;
+
+
+    // a value is a single 64 bit word. The low 3 bits is the type and bool,
+    // int and number are stored in the upper 32 bits. Strings are a pointer
+    // to a StringObject, they are at least 8 byte aligned so the tag can be
+    // stored in the low bits. Strings of up to 7 bytes are stored in the
+    // word itself with a tag of their own
+    struct Value
+    {
+        // null
+        Value();
+
+        Value(const Value& rhs);
+        Value(Value&& rhs) noexcept;
+        Value& operator=(const Value& rhs);
+        Value& operator=(Value&& rhs) noexcept;
+        ~Value();
+
+        static Value FromBool(bool b);
+        static Value FromInt(int i);
+        static Value FromFloat(float f);
+        static Value FromString(std::string str);
+
+        // a interned string, see fel/symboltable.h
+        static Value FromSymbol(const StringObject* symbol);
+
+        // lhs and rhs must be strings, long strings aren't copied but
+        // joined when the result is read. If a arena is passed the result is
+        // allocated there and is only valid until the arena is reset
+        static Value Concat(const Value& lhs, const Value& rhs, Arena* arena = nullptr);
+
+        // a copy of the value that doesn't point into a arena
+        static Value CopyOutOfArena(const Value& value);
+
+        ValueType
+        GetType() const;
+
+        bool
+        IsNull() const;
+
+        // the value must be of the type
+        bool AsBool() const;
+        int AsInt() const;
+        float AsNumber() const;
+
+        // a small string points into the value itself so the view is only
+        // valid as long as this value isn't changed
+        std::string_view AsString() const;
+
+        // join a concatenation now instead of when it's first read, a value
+        // that is read from many threads must be flattened before it's shared
+        void Flatten() const;
+
+    private:
+        std::uint64_t bits;
+
+        explicit Value(std::uint64_t b);
+
+        static Value
+        FromSmallString(std::string_view str);
+
+        static Value
+        FromStringObject(const StringObject* object);
+
+        StringObject*
+        GetStringObject() const;
+
+        void
+        AddReference() const;
+
+        void
+        RemoveReference();
+
+        bool
+        IsHeapString() const;
+
+        std::size_t
+        GetStringLength() const;
+
+        static void
+        Destroy(StringObject* object);
+
+        friend bool IsSameString(const Value& lhs, const Value& rhs);
+        friend struct StringObject;
+    };
+
+
+    // the heap part of a string value, reference counted by Value
+    struct StringObject
+    {
+        std::atomic<std::uint32_t> references {1};
+
+        // interned strings are owned by the symbol table and live forever,
+        // they aren't reference counted and the hash is only set for them
+        bool is_interned = false;
+        std::size_t hash = 0;
+
+        // strings allocated in a arena aren't reference counted either, they
+        // are released all at once with the arena. They only ever point to
+        // strings that aren't reference counted
+        Arena* arena = nullptr;
+
+        // a concatenation that hasn't been read is left and right and data
+        // is null, the first read joins them and releases them. It's not
+        // guarded so shared values are flattened first, see Value::Flatten
+        Value left;
+        Value right;
+        std::size_t length = 0;
+
+        // the text, either s or memory in the arena
+        const char* data = nullptr;
+        std::string s;
+
+        explicit StringObject(std::string ss);
+        StringObject(Value l, Value r, std::size_t len, Arena* a = nullptr);
+        StringObject(const char* d, std::size_t len, Arena* a);
+
+        bool
+        IsRope() const;
+
+        bool
+        IsCounted() const;
+
+        // join the pieces of a rope
+        void
+        Flatten();
+    };
+
+
+    static_assert(sizeof(Value) == sizeof(std::uint64_t), "a value should fit in a register");
+
+
+    std::string
+    Stringify(const Value& value);
+
+
+    // big enough for any value that isn't a string
+    constexpr std::size_t FormatBufferSize = 32;
+
+    // format the value like Stringify but without allocating, numbers are
+    // written to the buffer and strings point into the value
+    std::string_view
+    Format(const Value& value, char (&buffer)[FormatBufferSize]);
+
+
+    // both values must be strings, interned strings are compared by pointer
+    bool
+    IsSameString(const Value& lhs, const Value& rhs);
+
+
+    // the type name as used in error messages
+    std::string
+    ToString(ValueType type);
+
+
+    // ------------------------------------------------------------------------
+    // the small functions are here so they can be inlined in the interpreter
+
+    namespace value_detail
+    {
+        constexpr std::uint64_t TagMask = 0x7;
+        constexpr int PayloadShift = 32;
+
+        // the length is stored above the tag and the text in the other 7 bytes
+        constexpr std::uint64_t SmallStringTag = 5;
+        constexpr int SmallStringLengthShift = 3;
+        constexpr std::size_t SmallStringCapacity = sizeof(std::uint64_t) - 1;
+
+        constexpr std::uint64_t
+        Tag(ValueType type)
+        {
+            return static_cast<std::uint64_t>(type);
+        }
+
+        constexpr std::uint64_t
+        Payload(std::uint32_t payload, ValueType type)
+        {
+            return (static_cast<std::uint64_t>(payload) << PayloadShift) | Tag(type);
+        }
+    }
+
+
+    inline Value::Value()
+        : bits(value_detail::Tag(ValueType::Null))
+    {
+    }
+
+
+    inline Value::Value(std::uint64_t b)
+        : bits(b)
+    {
+    }
+
+
+    inline Value::Value(const Value& rhs)
+        : bits(rhs.bits)
+    {
+        AddReference();
+    }
+
+
+    inline Value::Value(Value&& rhs) noexcept
+        : bits(rhs.bits)
+    {
+        rhs.bits = value_detail::Tag(ValueType::Null);
+    }
+
+
+    inline Value&
+    Value::operator=(const Value& rhs)
+    {
+        rhs.AddReference();
+        RemoveReference();
+        bits = rhs.bits;
+        return *this;
+    }
+
+
+    inline Value&
+    Value::operator=(Value&& rhs) noexcept
+    {
+        if(this != &rhs)
+        {
+            RemoveReference();
+            bits = rhs.bits;
+            rhs.bits = value_detail::Tag(ValueType::Null);
+        }
+        return *this;
+    }
+
+
+    inline Value::~Value()
+    {
+        RemoveReference();
+    }
+
+
+    inline Value
+    Value::FromBool(bool b)
+    {
+        return Value{value_detail::Payload(b ? 1 : 0, ValueType::Bool)};
+    }
+
+
+    inline Value
+    Value::FromInt(int i)
+    {
+        return Value{value_detail::Payload(static_cast<std::uint32_t>(i), ValueType::Int)};
+    }
+
+
+    inline Value
+    Value::FromFloat(float f)
+    {
+        std::uint32_t payload;
+        std::memcpy(&payload, &f, sizeof(payload));
+        return Value{value_detail::Payload(payload, ValueType::Number)};
+    }
+
+
+    inline ValueType
+    Value::GetType() const
+    {
+        const auto tag = bits & value_detail::TagMask;
+        if(tag == value_detail::SmallStringTag) { return ValueType::String; }
+        return static_cast<ValueType>(tag);
+    }
+
+
+    inline bool
+    Value::IsNull() const
+    {
+        return GetType() == ValueType::Null;
+    }
+
+
+    inline bool
+    Value::AsBool() const
+    {
+        assert(GetType() == ValueType::Bool);
+        return (bits >> value_detail::PayloadShift) != 0;
+    }
+
+
+    inline int
+    Value::AsInt() const
+    {
+        assert(GetType() == ValueType::Int);
+        return static_cast<int>(static_cast<std::uint32_t>(bits >> value_detail::PayloadShift));
+    }
+
+
+    inline float
+    Value::AsNumber() const
+    {
+        assert(GetType() == ValueType::Number);
+        const auto payload = static_cast<std::uint32_t>(bits >> value_detail::PayloadShift);
+        float f;
+        std::memcpy(&f, &payload, sizeof(f));
+        return f;
+    }
+
+
+    inline StringObject*
+    Value::GetStringObject() const
+    {
+        return reinterpret_cast<StringObject*>(static_cast<std::uintptr_t>(bits & ~value_detail::TagMask));
+    }
+
+
+    inline Value
+    Value::FromSymbol(const StringObject* symbol)
+    {
+        assert(symbol->is_interned);
+        return FromStringObject(symbol);
+    }
+
+
+    inline Value
+    Value::FromStringObject(const StringObject* object)
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(object);
+        assert((address & value_detail::TagMask) == 0);
+        return Value{static_cast<std::uint64_t>(address) | value_detail::Tag(ValueType::String)};
+    }
+
+
+    inline bool
+    Value::IsHeapString() const
+    {
+        return (bits & value_detail::TagMask) == value_detail::Tag(ValueType::String);
+    }
+
+
+    inline std::string_view
+    Value::AsString() const
+    {
+        assert(GetType() == ValueType::String);
+        if(IsHeapString() == false)
+        {
+            const auto length = static_cast<std::size_t>((bits & 0xff) >> value_detail::SmallStringLengthShift);
+            return {reinterpret_cast<const char*>(&bits) + 1, length};
+        }
+
+        auto* object = GetStringObject();
+        if(object->IsRope()) { object->Flatten(); }
+        return {object->data, object->length};
+    }
+
+
+    inline void
+    Value::Flatten() const
+    {
+        if(IsHeapString() && GetStringObject()->IsRope())
+        {
+            GetStringObject()->Flatten();
+        }
+    }
+
+
+    inline void
+    Value::AddReference() const
+    {
+        if(IsHeapString() && GetStringObject()->IsCounted())
+        {
+            GetStringObject()->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+
+    inline void
+    Value::RemoveReference()
+    {
+        if(IsHeapString() && GetStringObject()->IsCounted())
+        {
+            auto* object = GetStringObject();
+            if(object->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                Destroy(object);
+            }
+        }
+    }
+
+
+    inline bool
+    StringObject::IsRope() const
+    {
+        return left.IsNull() == false;
+    }
+
+
+    inline bool
+    StringObject::IsCounted() const
+    {
+        return is_interned == false && arena == nullptr;
+    }
+}
+
+#endif  // FEL_VALUE_H
@@ -0,0 +1,133 @@
+#include "catch.hpp"
+
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#include "fel/value.h"
+
+using namespace fel;
+
+
+TEST_CASE("value", "[value]")
+{
+    CHECK(Value{}.GetType() == ValueType::Null);
+    CHECK(Stringify(Value{}) == "null");
+
+    CHECK(Value::FromBool(true).AsBool());
+    CHECK_FALSE(Value::FromBool(false).AsBool());
+    CHECK(Stringify(Value::FromBool(false)) == "false");
+
+    for(const int i: {0, 1, -1, std::numeric_limits<int>::max(), std::numeric_limits<int>::min()})
+    {
+        const auto v = Value::FromInt(i);
+        CHECK(v.GetType() == ValueType::Int);
+        CHECK(v.AsInt() == i);
+    }
+
+    for(const float f: {0.0f, -0.0f, 2.5f, -1e30f, std::numeric_limits<float>::infinity()})
+    {
+        const auto v = Value::FromFloat(f);
+        CHECK(v.GetType() == ValueType::Number);
+        CHECK(v.AsNumber() == f);
+    }
+
+    CHECK(ToString(ValueType::Number) == "number");
+}
+
+
+TEST_CASE("value-string", "[value]")
+{
+    const auto text = std::string{"a string that is too long to be small"};
+    auto a = Value::FromString(text);
+    CHECK(a.GetType() == ValueType::String);
+    CHECK(a.AsString() == text);
+
+    // copies share the string
+    auto b = a;
+    CHECK(b.AsString().data() == a.AsString().data());
+
+    auto c = std::move(a);
+    CHECK(a.IsNull());
+    CHECK(c.AsString() == text);
+
+    b = Value::FromInt(3);
+    c = c;
+    CHECK(Stringify(c) == text);
+    c = Value{};
+    CHECK(c.IsNull());
+}
+
+
+TEST_CASE("value-small-string", "[value]")
+{
+    for(const std::string text: {"", "a", "hello", "1234567", "12345678"})
+    {
+        const auto v = Value::FromString(text);
+        CHECK(v.GetType() == ValueType::String);
+        CHECK(v.AsString() == text);
+        CHECK(Stringify(v) == text);
+    }
+
+    CHECK(IsSameString(Value::FromString("dog"), Value::FromString("dog")));
+    CHECK_FALSE(IsSameString(Value::FromString("dog"), Value::FromString("dogs")));
+    CHECK(IsSameString(Value::FromString("dog"), Value::Concat(Value::FromString("d"), Value::FromString("og"))));
+}
+
+
+TEST_CASE("value-concat", "[value]")
+{
+    const auto piece = Value::FromString("0123456789");
+
+    std::string expected;
+    auto v = Value::FromString("");
+    for(int i=0; i<100; i+=1)
+    {
+        v = Value::Concat(v, piece);
+        expected += "0123456789";
+    }
+
+    // concatenations are shared and joined when read
+    const auto longer = Value::Concat(v, Value::FromString("!"));
+    CHECK(v.AsString() == expected);
+    CHECK(longer.AsString() == expected + "!");
+    CHECK(IsSameString(Value::Concat(Value::FromString(""), v), v));
+}
+
+
+TEST_CASE("value-concat-deep", "[value]")
+{
+    // too deep for recursion when it's joined and released
+    const auto piece = Value::FromString("x");
+    auto v = piece;
+    for(int i=0; i<1000000; i+=1)
+    {
+        v = Value::Concat(v, piece);
+    }
+    CHECK(v.AsString().size() == 1000001);
+
+    auto unread = piece;
+    for(int i=0; i<1000000; i+=1)
+    {
+        unread = Value::Concat(piece, unread);
+    }
+}
+
+
+TEST_CASE("value-format", "[value]")
+{
+    char buffer[FormatBufferSize];
+    CHECK(Format(Value{}, buffer) == "null");
+    CHECK(Format(Value::FromBool(true), buffer) == "true");
+    CHECK(Format(Value::FromInt(-42), buffer) == "-42");
+    CHECK(Format(Value::FromInt(std::numeric_limits<int>::min()), buffer) == "-2147483648");
+    CHECK(Format(Value::FromString("cat"), buffer) == "cat");
+
+    // the same as printing to a ostream
+    for(const float f: {0.0f, 2.5f, 0.1f, 1.0f/3.0f, 1234567.0f, -1e30f, 1e-7f, std::numeric_limits<float>::max()})
+    {
+        std::ostringstream ss;
+        ss << f;
+        CHECK(Format(Value::FromFloat(f), buffer) == ss.str());
+    }
+}
@@ -0,0 +1,228 @@
+#include "fel/vm.h"
+
+#include <cassert>
+#include <functional>
+#include <string>
+
+#include "fel/interpreter.h"
+#include "fel/log.h"
+
+// computed goto jumps directly to the next instruction instead of going back
+// to the top of a switch, it's a extension so fall back to the switch
+#if defined(__GNUC__) || defined(__clang__)
+#define FEL_VM_COMPUTED_GOTO 1
+#else
+#define FEL_VM_COMPUTED_GOTO 0
+#endif
+
+namespace fel
+{
+    namespace
+    {
+        bool
+        IsNumber(const Value& value)
+        {
+            const auto type = value.GetType();
+            return type == ValueType::Int || type == ValueType::Number;
+        }
+
+
+        float
+        ToFloat(const Value& value)
+        {
+            return value.GetType() == ValueType::Int ? static_cast<float>(value.AsInt()) : value.AsNumber();
+        }
+
+
+        bool
+        IsInts(const Value& lhs, const Value& rhs)
+        {
+            return lhs.GetType() == ValueType::Int && rhs.GetType() == ValueType::Int;
+        }
+
+
+        bool
+        IsTruthy(const Value& value)
+        {
+            switch(value.GetType())
+            {
+            case ValueType::Null: return false;
+            case ValueType::Bool: return value.AsBool();
+            default: return true;
+            }
+        }
+    }
+
+
+    Vm::Vm(Log* l)
+        : log(l)
+    {
+    }
+
+
+#if FEL_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+
+    Value
+    Vm::Run(const Code& code)
+    {
+        assert(code.ast != nullptr);
+        assert(!code.instructions.empty() && code.instructions.back().op == OpCode::Return);
+
+        const auto& ast = *code.ast;
+        arena.Reset();
+        registers.assign(code.register_count, Value{});
+
+        Value* r = registers.data();
+        const auto* first = code.instructions.data();
+        const auto* instruction = first;
+
+        // the fast paths only handle ints and numbers, everything else is
+        // passed on to the same functions as the interpreter
+        const auto binary = [&]()
+        {
+            const auto node = code.nodes[static_cast<std::size_t>(instruction - first)];
+            return EvaluateBinaryOperation(log, &arena, ast, node, r[instruction->a], r[instruction->b]);
+        };
+        const auto unary = [&]()
+        {
+            const auto node = code.nodes[static_cast<std::size_t>(instruction - first)];
+            return EvaluateUnaryOperation(log, ast, node, r[instruction->a]);
+        };
+
+#if FEL_VM_COMPUTED_GOTO
+        // same order as OpCode
+        static const void* const labels[] =
+        {
+            &&op_LoadLiteral, &&op_LoadVariable,
+            &&op_Add, &&op_Subtract, &&op_Multiply, &&op_Divide, &&op_Modulo,
+            &&op_Less, &&op_LessEqual, &&op_Greater, &&op_GreaterEqual, &&op_Equal, &&op_NotEqual,
+            &&op_Negate, &&op_Not,
+            &&op_Return
+        };
+        static_assert(sizeof(labels) / sizeof(labels[0]) == static_cast<std::size_t>(OpCode::Return) + 1, "a label for every opcode");
+        #define FEL_VM_CASE(name) op_##name
+        #define FEL_VM_NEXT() instruction += 1; goto *labels[static_cast<std::size_t>(instruction->op)]
+        goto *labels[static_cast<std::size_t>(instruction->op)];
+#else
+        #define FEL_VM_CASE(name) case OpCode::name
+        #define FEL_VM_NEXT() instruction += 1; goto dispatch
+    dispatch:
+        switch(instruction->op)
+#endif
+        {
+        FEL_VM_CASE(LoadLiteral):
+            r[instruction->dst] = ast.literals[static_cast<std::size_t>(instruction->a) | (static_cast<std::size_t>(instruction->b) << 16)];
+            FEL_VM_NEXT();
+
+        FEL_VM_CASE(LoadVariable):
+            {
+                const auto node = code.nodes[static_cast<std::size_t>(instruction - first)];
+                log->AddError(ast.GetWhere(node), log::Type::UnknownVariable, {std::string{ast.GetVariable(node)->s}});
+                r[instruction->dst] = Value{};
+            }
+            FEL_VM_NEXT();
+
+        // ints wrap instead of overflowing like the interpreter
+        #define FEL_VM_ARITHMETIC(name, operation) \
+        FEL_VM_CASE(name): \
+            { \
+                const auto& lhs = r[instruction->a]; \
+                const auto& rhs = r[instruction->b]; \
+                if(IsInts(lhs, rhs)) { r[instruction->dst] = Value::FromInt(WrapInt(operation{}, lhs.AsInt(), rhs.AsInt())); } \
+                else if(IsNumber(lhs) && IsNumber(rhs)) { r[instruction->dst] = Value::FromFloat(operation{}(ToFloat(lhs), ToFloat(rhs))); } \
+                else { r[instruction->dst] = binary(); } \
+            } \
+            FEL_VM_NEXT();
+
+        FEL_VM_ARITHMETIC(Add, std::plus<>)
+        FEL_VM_ARITHMETIC(Subtract, std::minus<>)
+        FEL_VM_ARITHMETIC(Multiply, std::multiplies<>)
+        #undef FEL_VM_ARITHMETIC
+
+        FEL_VM_CASE(Divide):
+            {
+                // always a number, there is no integer division
+                const auto& lhs = r[instruction->a];
+                const auto& rhs = r[instruction->b];
+                if(IsNumber(lhs) && IsNumber(rhs)) { r[instruction->dst] = Value::FromFloat(ToFloat(lhs) / ToFloat(rhs)); }
+                else { r[instruction->dst] = binary(); }
+            }
+            FEL_VM_NEXT();
+
+        FEL_VM_CASE(Modulo):
+            {
+                const auto& lhs = r[instruction->a];
+                const auto& rhs = r[instruction->b];
+                // a undefined modulo is reported by the shared operation
+                if(IsInts(lhs, rhs) && IsDefinedModulo(lhs.AsInt(), rhs.AsInt())) { r[instruction->dst] = Value::FromInt(lhs.AsInt() % rhs.AsInt()); }
+                else { r[instruction->dst] = binary(); }
+            }
+            FEL_VM_NEXT();
+
+        // ints are compared as numbers like the interpreter does
+        #define FEL_VM_COMPARE(name, op) \
+        FEL_VM_CASE(name): \
+            { \
+                const auto& lhs = r[instruction->a]; \
+                const auto& rhs = r[instruction->b]; \
+                if(IsNumber(lhs) && IsNumber(rhs)) { r[instruction->dst] = Value::FromBool(ToFloat(lhs) op ToFloat(rhs)); } \
+                else { r[instruction->dst] = binary(); } \
+            } \
+            FEL_VM_NEXT();
+
+        FEL_VM_COMPARE(Less, <)
+        FEL_VM_COMPARE(LessEqual, <=)
+        FEL_VM_COMPARE(Greater, >)
+        FEL_VM_COMPARE(GreaterEqual, >=)
+        #undef FEL_VM_COMPARE
+
+        #define FEL_VM_EQUAL(name, op) \
+        FEL_VM_CASE(name): \
+            { \
+                const auto& lhs = r[instruction->a]; \
+                const auto& rhs = r[instruction->b]; \
+                if(IsInts(lhs, rhs)) { r[instruction->dst] = Value::FromBool(lhs.AsInt() op rhs.AsInt()); } \
+                else { r[instruction->dst] = binary(); } \
+            } \
+            FEL_VM_NEXT();
+
+        FEL_VM_EQUAL(Equal, ==)
+        FEL_VM_EQUAL(NotEqual, !=)
+        #undef FEL_VM_EQUAL
+
+        FEL_VM_CASE(Negate):
+            {
+                const auto& operand = r[instruction->a];
+                switch(operand.GetType())
+                {
+                case ValueType::Int: r[instruction->dst] = Value::FromInt(NegateInt(operand.AsInt())); break;
+                case ValueType::Number: r[instruction->dst] = Value::FromFloat(operand.AsNumber() * -1); break;
+                default: r[instruction->dst] = unary(); break;
+                }
+            }
+            FEL_VM_NEXT();
+
+        FEL_VM_CASE(Not):
+            r[instruction->dst] = Value::FromBool(!IsTruthy(r[instruction->a]));
+            FEL_VM_NEXT();
+
+        FEL_VM_CASE(Return):
+            return Value::CopyOutOfArena(r[instruction->a]);
+        }
+
+        #undef FEL_VM_CASE
+        #undef FEL_VM_NEXT
+
+        assert(false && "invalid opcode");
+        return {};
+    }
+
+
+#if FEL_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef FEL_VM_H
+#define FEL_VM_H
+
+#include <vector>
+
+#include "fel/arena.h"
+#include "fel/bytecode.h"
+#include "fel/value.h"
+
+namespace fel
+{
+    struct Log;
+
+
+    // runs compiled code, gives the same result and reports the same errors
+    // as the Interpreter
+    struct Vm
+    {
+        explicit Vm(Log* l);
+
+        // like the interpreter the values made while running are allocated
+        // in the arena and only the result is copied out
+        Value
+        Run(const Code& code);
+
+        Log* log;
+        Arena arena;
+        std::vector<Value> registers;
+    };
+}
+
+#endif  // FEL_VM_H
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+
+#include "fel/bytecode.h"
+#include "fel/file.h"
+#include "fel/interpreter.h"
+#include "fel/log.h"
+#include "fel/parser.h"
+#include "fel/vm.h"
+
+using namespace fel;
+
+
+TEST_CASE("vm", "[vm]")
+{
+    // the vm should give the same result and errors as the interpreter
+    const std::vector<std::string> sources =
+    {
+        "1 + 2 * 3", "(1 + 2) * 3", "-4 - -2", "7 / 2", "1.5 * 2", "2 * 1.5 + 1",
+        "1 < 2", "2.5 >= 2", "3 == 3", "3 != 3", "3 == 3.0", "true == false",
+        "null == null", "null != 1", "!null", "!0", "!!true",
+        "'a' + 'b'", "'a' == 'a'", "'a string that is long enough' + ' to not be small' + '!'",
+        "1 + 'a'", "null + 1", "-'a'", "-true", "'a' < 'b'", "(1 + null) * 2",
+        "x + y", "x", "-x", "!x", "null == x", "(x + 1) * y",
+        "2147483647 + 1", "(0 - 2147483647) - 2", "65536 * 65536", "-(0 - 2147483647 - 1)"
+    };
+
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+
+        Log parse_log;
+        auto parser = Parser{file, &parse_log};
+        const auto ast = parser.Parse();
+        REQUIRE(ast);
+        REQUIRE(parse_log.IsEmpty());
+
+        Log interpreter_log;
+        auto interpreter = Interpreter{&interpreter_log};
+        const auto expected = interpreter.Evaluate(*ast);
+
+        Log vm_log;
+        const auto code = Compile(*ast, &vm_log);
+        REQUIRE(code);
+        auto vm = Vm{&vm_log};
+        const auto result = vm.Run(*code);
+
+        CHECK(result.GetType() == expected.GetType());
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(vm_log.entries == interpreter_log.entries);
+
+        // running again gives the same result
+        CHECK(Stringify(vm.Run(*code)) == Stringify(expected));
+    }
+}
+
+
+TEST_CASE("vm-registers", "[vm]")
+{
+    const auto file = File{"source", std::string{"1 + 2 + 3 + 4 + (5 + (6 + 7))"}};
+    Log log;
+    auto parser = Parser{file, &log};
+    const auto ast = parser.Parse();
+    REQUIRE(ast);
+
+    const auto code = Compile(*ast, &log);
+    REQUIRE(code);
+
+    // the left side reuses the target register, only the right side nests
+    CHECK(code->register_count == 4);
+    CHECK(code->instructions.size() == ast->nodes.size() - 2 + 1);
+    CHECK(code->instructions.back().op == OpCode::Return);
+    CHECK(ToString(code->instructions[0].op) == "LoadLiteral");
+    CHECK(Stringify(Vm{&log}.Run(*code)) == "28");
+}
+
+
+TEST_CASE("vm-modulo", "[vm]")
+{
+    // there is no syntax for modulo yet so the root operator is replaced
+    const std::vector<std::string> sources = {"7 + 3", "-7 + 3", "7 + 0", "(0 - 2147483647 - 1) + -1"};
+    for(const auto& source: sources)
+    {
+        INFO(source);
+        const auto file = File{"source", source};
+        Log parse_log;
+        auto parser = Parser{file, &parse_log};
+        auto ast = parser.Parse();
+        REQUIRE(ast);
+        ast->nodes[ast->root].op = TokenType::Mod;
+
+        Log interpreter_log;
+        const auto expected = Interpreter{&interpreter_log}.Evaluate(*ast);
+
+        Log vm_log;
+        const auto code = Compile(*ast, &vm_log);
+        REQUIRE(code);
+        const auto result = Vm{&vm_log}.Run(*code);
+
+        CHECK(Stringify(result) == Stringify(expected));
+        CHECK(vm_log.entries == interpreter_log.entries);
+    }
+}
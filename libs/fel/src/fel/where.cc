@@ -6,7 +6,7 @@
 
 namespace fel
 {
-    Where::Where(const std::string& f, const Location& l)
+    Where::Where(FileId f, const Location& l)
         : file(f)
         , location(l)
     {
@@ -14,8 +14,8 @@ namespace fel
 
 
     Where::Where(const FilePointer& f)
-        : file(f.file.filename)
-        , location(f.location)
+        : file(f.file.id)
+        , location(f.GetLocation())
     {
     }
     
@@ -32,7 +32,7 @@ namespace fel
     std::ostream&
     operator<<(std::ostream& o, const Where& w)
     {
-        o  << w.file
+        o  << GetFileName(w.file)
             << "("
             << w.location.line << ":" << w.location.column
             << ")";
@@ -3,6 +3,7 @@
 
 #include <string>
 
+#include "fel/filetable.h"
 #include "fel/location.h"
 #include <iostream>
 
@@ -11,13 +12,14 @@ namespace fel
 {
     struct FilePointer;
 
+    // the filename is only looked up when printed
     struct Where
     {
-        std::string file = "<undefined>";
+        FileId file = UndefinedFile;
         Location location = {};
 
         Where() = default;
-        Where(const std::string& file, const Location& location);
+        Where(FileId file, const Location& location);
         explicit Where(const FilePointer& file);
     };
 
@@ -30,6 +32,6 @@ namespace fel
     operator<<(std::ostream& o, const Where& w);
 }
 
-#define FEL_WHERE_HERE ::fel::Where{__FILE__, {__LINE__}}
+#define FEL_WHERE_HERE ::fel::Where{::fel::InternFileName(__FILE__), {__LINE__}}
 
-#endif  // FEL_WHERE_H
\ No newline at end of file
+#endif  // FEL_WHERE_H
@@ -0,0 +1,139 @@
+#include "fel/writer.h"
+
+#include <cerrno>
+#include <system_error>
+
+namespace fel
+{
+    ChunkWriter
+    WriteToFile(std::FILE* file)
+    {
+        return [file](std::string_view data, std::string* error)
+        {
+            // the writer already buffers so flush right away, otherwise a
+            // error would only be seen when the file is closed
+            const auto written = std::fwrite(data.data(), 1, data.size(), file);
+            if(written != data.size() || std::fflush(file) != 0)
+            {
+                *error = std::generic_category().message(errno);
+                return false;
+            }
+            return true;
+        };
+    }
+
+
+    ChunkWriter
+    WriteToString(std::string* str)
+    {
+        return [str](std::string_view data, std::string*)
+        {
+            str->append(data);
+            return true;
+        };
+    }
+
+
+    Writer::Writer(ChunkWriter a_writer, std::size_t a_buffer_size)
+        : writer(std::move(a_writer))
+        , buffer_size(a_buffer_size)
+    {
+        buffer.reserve(buffer_size);
+    }
+
+
+    Writer::~Writer()
+    {
+        Flush();
+    }
+
+
+    void
+    Writer::Write(std::string_view text)
+    {
+        if(buffer.size() + text.size() > buffer_size)
+        {
+            Flush();
+
+            // no point in copying something that fills the buffer anyway
+            if(text.size() >= buffer_size)
+            {
+                Pass(text);
+                return;
+            }
+        }
+        buffer.append(text);
+    }
+
+
+    void
+    Writer::Write(char c)
+    {
+        if(buffer.size() + 1 > buffer_size)
+        {
+            Flush();
+        }
+        buffer.push_back(c);
+    }
+
+
+    void
+    Writer::Write(const Value& value)
+    {
+        char formatted[FormatBufferSize];
+        Write(Format(value, formatted));
+    }
+
+
+    void
+    Writer::Flush()
+    {
+        if(!buffer.empty())
+        {
+            Pass(buffer);
+            buffer.clear();
+        }
+    }
+
+
+    bool
+    Writer::HasFailed() const
+    {
+        return failed;
+    }
+
+
+    void
+    Writer::Pass(std::string_view data)
+    {
+        if(failed)
+        {
+            return;
+        }
+        failed = !writer(data, &error);
+    }
+
+
+    Writer&
+    operator<<(Writer& writer, std::string_view text)
+    {
+        writer.Write(text);
+        return writer;
+    }
+
+
+    Writer&
+    operator<<(Writer& writer, char c)
+    {
+        writer.Write(c);
+        return writer;
+    }
+
+
+    Writer&
+    operator<<(Writer& writer, const Value& value)
+    {
+        writer.Write(value);
+        return writer;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef FEL_WRITER_H
+#define FEL_WRITER_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "fel/value.h"
+
+namespace fel
+{
+    // writes all of the data somewhere, if writing failed the reason is set
+    // in error and false is returned
+    using ChunkWriter = std::function<bool (std::string_view data, std::string* error)>;
+
+
+    ChunkWriter
+    WriteToFile(std::FILE* file);
+
+
+    ChunkWriter
+    WriteToString(std::string* str);
+
+
+    // collects small writes and passes them on in big chunks so printing many
+    // small things doesn't turn into many small syscalls
+    struct Writer
+    {
+        static constexpr std::size_t DefaultBufferSize = 64 * 1024;
+
+        explicit Writer(ChunkWriter a_writer, std::size_t a_buffer_size = DefaultBufferSize);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void
+        Write(std::string_view text);
+
+        void
+        Write(char c);
+
+        void
+        Write(const Value& value);
+
+        // pass on everything that has been written
+        void
+        Flush();
+
+        // true if a write has failed, everything after it is dropped
+        bool
+        HasFailed() const;
+
+        ChunkWriter writer;
+        std::size_t buffer_size;
+        std::string error;
+
+    private:
+        void
+        Pass(std::string_view data);
+
+        std::string buffer;
+        bool failed = false;
+    };
+
+
+    Writer&
+    operator<<(Writer& writer, std::string_view text);
+
+    Writer&
+    operator<<(Writer& writer, char c);
+
+    Writer&
+    operator<<(Writer& writer, const Value& value);
+}
+
+#endif  // FEL_WRITER_H
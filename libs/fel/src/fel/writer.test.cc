@@ -0,0 +1,74 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "fel/writer.h"
+
+using namespace fel;
+
+
+TEST_CASE("writer", "[writer]")
+{
+    std::vector<std::string> chunks;
+    {
+        auto writer = Writer{[&](std::string_view data, std::string*) { chunks.emplace_back(data); return true; }, 8};
+        writer << "abc" << ' ' << Value::FromInt(42);
+        CHECK(chunks.empty());
+
+        writer << "def";
+        REQUIRE(chunks.size() == 1);
+        CHECK(chunks[0] == "abc 42");
+
+        // too big for the buffer, written as is
+        writer << "a long line";
+        REQUIRE(chunks.size() == 3);
+        CHECK(chunks[1] == "def");
+        CHECK(chunks[2] == "a long line");
+
+        writer << Value::FromBool(false);
+    }
+    REQUIRE(chunks.size() == 4);
+    CHECK(chunks[3] == "false");
+}
+
+
+TEST_CASE("writer-error", "[writer]")
+{
+    int writes = 0;
+    auto writer = Writer{[&](std::string_view, std::string* error)
+    {
+        writes += 1;
+        *error = "disk full";
+        return false;
+    }, 4};
+
+    writer << "abc";
+    CHECK_FALSE(writer.HasFailed());
+
+    // the first failure is kept and nothing more is written
+    writer << "def" << "a long line";
+    CHECK(writer.HasFailed());
+    CHECK(writer.error == "disk full");
+    writer.Flush();
+    CHECK(writes == 1);
+}
+
+
+#if defined(__linux__)
+TEST_CASE("writer-file-error", "[writer]")
+{
+    // every write to /dev/full fails with no space left
+    auto* file = std::fopen("/dev/full", "w");
+    REQUIRE(file != nullptr);
+    {
+        auto writer = Writer{WriteToFile(file)};
+        writer << "some text";
+        writer.Flush();
+        CHECK(writer.HasFailed());
+        CHECK_FALSE(writer.error.empty());
+    }
+    std::fclose(file);
+}
+#endif